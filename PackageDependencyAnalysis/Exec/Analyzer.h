@@ -25,41 +25,78 @@ and save Graph as XML to disk.
 Public Interface:
 =================
 Analyzer(path, pattern, isRecursive);
+Analyzer(path, pattern, isRecursive, workers);
+Analyzer(path, pattern, isRecursive, workers, cacheFile);	// unchanged files are not parsed again
+Analyzer(arrayOfFile, workers, cacheFile);	// these files, without walking a path
+Analyzer::ignore(excludeRules, ".gitignore");	// rules for paths under path or the given files, and the ignore file name
 Analyzer::doWork();
+Analyzer::watch();	// doWork(), then again whenever files under path change
 
 Build Process:
 ==============
 Required files
-- Graph.h, Display.h, SymbolTable.h, FileManager.h
+- Graph.h, Display.h, SymbolTable.h, SymbolDatabase.h, FileManager.h, AnalysisCache.h,
+  DirectoryWatcher.h, DirectoryWalker.h
 
 Maintenance History:
 ====================
+ver 0.9 : 17 Oct 26
+- watch() keeps the graph, replaces only the edges of the tables analyzed again, searches again
+  only the strong components they reach and shows what changed instead of the whole graph
+- the graph is kept when changed files cannot be parsed
+ver 0.8 : 17 Oct 26
+- ignore() also leaves out given files
+- watch() parses only the packages of changed files and analyzes only the tables they affect
+ver 0.7 : 17 Oct 26
+- an Analyzer can be given the list of files to parse instead of a path
+ver 0.6 : 17 Oct 26
+- added ignore(), ignored files and directories are neither parsed nor watched
+ver 0.5 : 17 Oct 26
+- the worker threads also list the directories under path
+ver 0.4 : 17 Oct 26
+- added watch(), which parses only the files changed since the last batch
+ver 0.3 : 17 Oct 26
+- facts of parsed files can be kept in an AnalysisCache between runs
+ver 0.2 : 17 Oct 26
+- files can be parsed by a pool of worker threads
+- each Analyzer owns its SymbolDatabase
 ver 0.1 : 19 Mar 13
 - first version
 
 */
 
 #include <iostream>
+#include <unordered_set>
+#include <set>
+#include <map>
+#include <algorithm>
 #include "Graph.h"
 #include "Display.h"
 #include "SymbolTable.h"
+#include "SymbolDatabase.h"
 #include "FileManager.h"
+#include "AnalysisCache.h"
+#include "DirectoryWatcher.h"
 
 ///////////////////////////////////////////////////////////////
 // Analyzer class
 class Analyzer {
 	typedef GraphLib::Graph<std::string, std::string> graph;	// file graph
 	typedef GraphLib::Vertex<std::string, std::string> vertex;	// file vertex
+	typedef GraphLib::SCCSearcher<std::string, std::string> searcher;	// strong components of the file graph
 
 	//----< convert SymbolTable into Graph >-----------------------------------
 	void convertToGraph() {
-		for (SymbolTable::iterator it=SymbolTable::begin(); it!=SymbolTable::end(); it++) {
+		pGraph->reserve(symbols.size());
+		GraphLib::EdgeBuilder<std::string, std::string> builder(*pGraph);
+		for (SymbolDatabase::iterator it=symbols.begin(); it!=symbols.end(); it++) {
 			size_t pIndex = pGraph->addOrFindVertexByVal(it->first);
 			for (const auto & package : it->second->files()) {
 				size_t cIndex = pGraph->addOrFindVertexByVal(package);
-				pGraph->addEdge((*pGraph)[cIndex].value(), (*pGraph)[pIndex], (*pGraph)[cIndex]);
+				builder.add(package, pIndex, cIndex);
 			}
 		}
+		builder.finalize();
 	}
 
 	//----< save Graph to disk >-----------------------------------
@@ -67,44 +104,342 @@ class Analyzer {
 		std::string xml = GraphLib::GraphToXmlString<std::string, std::string>(*pGraph);
 		FileManager::save(path, xml);
 	}
+	//----< search dependencies of the parsed files, save and show the results >--
+	void analyzeSymbols() {
+		std::cout<<"\n\n Searching for package dependency...";
+		symbols.analyzeAll();
+		convertToGraph();
+		saveGraph();
+		std::cout<<"\n Graph has been save to ./graph.xml";
+		GraphLib::Display<std::string, std::string>::show(*pGraph);
+		std::cout<<"\n Now searching for strong components...";
+		delete pSearcher;
+		pSearcher = new searcher(pGraph);	// kept for the changes watch() finds
+		pSearcher->search();
+		std::cout<<"\n Sorting strong components...";
+		GraphLib::SCCSorter<std::string, size_t> sorter(&pSearcher->Graph());
+		sorter.sort();
+		// output sorted strong components
+		sorter.show();
+		std::cout<<"\n\n Done!! All relationship has been analyzed.\n";
+	}
+
+	//----< analyze the packages of a batch of changes, update the graph and show what changed >--
+	// only the tables which changed or include a changed one are analyzed, only their edges are
+	// replaced and only the strong components those edges reach are searched again; when the
+	// changed files could not be parsed, the graph is kept until a batch is parsed
+	void analyzeChanges(bool isParsed) {
+		std::cout<<"\n\n Searching for package dependency changes...";
+		std::vector<std::string> analyzed = symbols.analyzeChanged();	// the database stays whole for the next batch
+		unapplied.insert(analyzed.begin(), analyzed.end());
+		if (!isParsed) {
+			std::cout<<"\n Changed files could not be parsed, the graph is kept as it was\n";
+			return;
+		}
+		std::map<std::string, std::string> before = componentsByPackages();
+		std::vector<size_t> changed, newIndex;
+		if (!updateGraph(changed, newIndex)) {
+			std::cout<<"\n No package dependency changed\n";
+			return;
+		}
+		saveGraph();
+		std::cout<<"\n Graph has been save to ./graph.xml";
+		std::cout<<"\n Now searching for changed strong components...";
+		pSearcher->update(changed, newIndex);
+		std::cout<<"\n Sorting strong components...";
+		GraphLib::SCCSorter<std::string, size_t> sorter(&pSearcher->Graph());
+		sorter.sort();
+		// output the strong components which are new, in sorted order, then those which are gone
+		std::map<std::string, std::string> after = componentsByPackages(), packagesOf;
+		for (std::map<std::string, std::string>::iterator it=after.begin(); it!=after.end(); it++)
+			packagesOf[it->second] = it->first;
+		std::vector<std::string> sorted = sorter.values();
+		std::cout<<"\n Changed strong components in topological order -----";
+		for (size_t i=0;i<sorted.size();i++)
+			if (!before.count(packagesOf[sorted[i]])) std::cout<<"\n + "<<sorted[i];
+		for (std::map<std::string, std::string>::iterator it=before.begin(); it!=before.end(); it++)
+			if (!after.count(it->first)) std::cout<<"\n - "<<it->second;
+		std::cout<<"\n\n Done!! Changed relationship has been analyzed.\n";
+	}
+
+	//----< replace the edges of the packages analyzed again, remove packages which are gone >--
+	// shows the edges added and removed, returns whether any changed; changed gets the vertices
+	// whose edges changed, newIndex the index now of every vertex before, (size_t)-1 if removed
+	bool updateGraph(std::vector<size_t>& changed, std::vector<size_t>& newIndex) {
+		std::vector<std::string> packages(unapplied.begin(), unapplied.end());
+		std::sort(packages.begin(), packages.end());
+		unapplied.clear();
+		size_t old = pGraph->size();
+		std::vector<bool> isRemoved;
+		std::cout<<"\n\n Outputing changed Package usage --------";
+		for (size_t i=0;i<packages.size();i++) {
+			SymbolTable* pTable = symbols.find(packages[i]);
+			size_t pIndex = pGraph->addOrFindVertexByVal(packages[i]);
+			std::set<std::string> was, now;
+			for (auto edge : (*pGraph)[pIndex]) was.insert(edge.second);
+			(*pGraph)[pIndex].clear();
+			if (pTable) {
+				for (const auto & package : pTable->files()) {
+					size_t cIndex = pGraph->addOrFindVertexByVal(package);
+					vertex::Edge edge((int)cIndex, package);
+					(*pGraph)[pIndex].add(edge);
+					now.insert(package);
+				}
+			}
+			else {	// the package is gone
+				isRemoved.resize(pGraph->size(), false);
+				isRemoved[pIndex] = true;
+				if (pIndex<old) std::cout<<"\n  PACKAGE ["<<packages[i]<<"] IS GONE";
+			}
+			if (was==now) continue;
+			changed.push_back(pIndex);
+			if (pTable) std::cout<<"\n  PACKAGE ["<<packages[i]<<"] LINKS TO";
+			for (std::set<std::string>::iterator it=now.begin(); it!=now.end(); it++)
+				if (!was.count(*it)) std::cout<<"\n    + PACKAGE ["<<*it<<"]";
+			for (std::set<std::string>::iterator it=was.begin(); it!=was.end(); it++)
+				if (!now.count(*it)) std::cout<<"\n    - PACKAGE ["<<*it<<"]";
+		}
+		std::cout<<"\n";
+		bool isChanged = !changed.empty();	// or a vertex before is removed, or a new one is kept
+		for (size_t i=0;!isChanged && i<pGraph->size();i++)
+			isChanged = (i<isRemoved.size() && isRemoved[i])!=(i>=old);
+		newIndex = pGraph->removeVertices(isRemoved);
+		size_t kept = 0;
+		for (size_t i=0;i<changed.size();i++)
+			if (newIndex[changed[i]]!=(size_t)-1)
+				changed[kept++] = newIndex[changed[i]];
+		changed.resize(kept);
+		newIndex.resize(old);	// vertices added since are new to the searcher
+		return isChanged;
+	}
+
+	//----< values of the strong components found last, by their sorted packages >--
+	// a component found again may list its packages in another order
+	std::map<std::string, std::string> componentsByPackages() {
+		std::map<std::string, std::string> found;
+		for (size_t i=0;i<pSearcher->Components().size();i++) {
+			std::vector<std::string> packages;
+			for (size_t vIndex : pSearcher->Components()[i])
+				packages.push_back((*pGraph)[vIndex].value());
+			std::sort(packages.begin(), packages.end());
+			std::string key;
+			for (size_t k=0;k<packages.size();k++)
+				key += packages[k] + "\n";
+			found[key] = pSearcher->Graph()[i].value();
+		}
+		return found;
+	}
+
+	//----< watch directory, and its subdirectories if recursive >-----------
+	void watchDirectory(DirectoryWatcher& watcher, const std::string& dir) {
+		std::set<std::pair<unsigned long long, unsigned long long> > watched;
+		watchDirectory(watcher, dir, PatternSet(patterns), rules, watched);
+	}
+
+	//----< watch directory and the subdirectories the walk would list, each once >--
+	void watchDirectory(DirectoryWatcher& watcher, std::string dir, const PatternSet& names, const IgnoreRules& dirRules,
+		std::set<std::pair<unsigned long long, unsigned long long> >& watched) {
+		if (dir[dir.length()-1]!='/' && dir[dir.length()-1]!='\\')
+			dir += "/";	// the same directory strings as FileManager::getFileList()
+		DirectoryWalker::Listing listing;
+		if (!DirectoryWalker::list(dir, names, listing, rules.ignoreFile())) return;
+		if (listing.inode!=0 && !watched.insert(std::make_pair(listing.device, listing.inode)).second)
+			return;	// met again through a link
+		watcher.add(dir);
+		if (!isRecursive) return;
+		IgnoreRules ownRules;
+		const IgnoreRules* pRules = &dirRules;
+		if (listing.hasIgnoreFile) {	// its rules hold for this directory and below, as in the walk
+			ownRules = dirRules;
+			ownRules.read(dir+rules.ignoreFile(), dir);
+			pRules = &ownRules;
+		}
+		for (size_t i=0;i<listing.directories.size();i++)
+			if (!pRules->ignored(dir+listing.directories[i], true))
+				watchDirectory(watcher, dir+listing.directories[i], names, *pRules, watched);
+	}
+
+	//----< add the files not listed yet, noting them as touched >-------------
+	static void addFiles(const std::vector<std::string>& found, std::vector<std::string>& files,
+		std::unordered_set<std::string>& listed, std::vector<std::string>& touched) {
+		for (size_t i=0;i<found.size();i++)
+			if (listed.insert(found[i]).second) {
+				files.push_back(found[i]);
+				touched.push_back(found[i]);
+			}
+	}
+
+	//----< update file list and cache for changes, return whether files changed >--
+	// touched gets the files which changed, were added or are gone
+	bool applyChanges(DirectoryWatcher& watcher, const std::vector<DirectoryWatcher::Change>& changes,
+		std::vector<std::string>& files, AnalysisCache& cache, std::vector<std::string>& touched) {
+		std::unordered_set<std::string> listed(files.begin(), files.end());
+		for (size_t i=0;i<changes.size();i++) {
+			std::string file = changes[i].path();
+			switch (changes[i].kind) {
+			case DirectoryWatcher::Overflow:	// anything may have changed, walk the tree again
+				watchDirectory(watcher, path);
+				touched.insert(touched.end(), files.begin(), files.end());
+				files = listFiles();
+				touched.insert(touched.end(), files.begin(), files.end());
+				return true;
+			case DirectoryWatcher::Modified:
+			case DirectoryWatcher::Created:	// or replaced by a rename
+				cache.forget(file);
+				if (changes[i].kind==DirectoryWatcher::Created)	// new files are matched by listing the directory
+					addFiles(FileManager::getFileList(changes[i].directory, false, patterns, 1, &rules), files, listed, touched);
+				if (listed.count(file)) touched.push_back(file);
+				break;
+			case DirectoryWatcher::Deleted:
+				cache.forget(file);
+				if (listed.erase(file)) touched.push_back(file);
+				break;
+			case DirectoryWatcher::DirectoryCreated:
+				if (!isRecursive || rules.ignored(file, true)) break;
+				watchDirectory(watcher, file);
+				addFiles(FileManager::getFileList(file, true, patterns, 1, &rules), files, listed, touched);
+				break;
+			case DirectoryWatcher::DirectoryDeleted:
+				file += "/";
+				for (std::unordered_set<std::string>::iterator it=listed.begin(); it!=listed.end();)
+					if (it->compare(0, file.length(), file)==0) {
+						cache.forget(*it);
+						touched.push_back(*it);
+						it = listed.erase(it);
+					}
+					else it++;
+				break;
+			}
+		}
+		// drop the files which are gone, keeping the others in order
+		std::vector<std::string> kept;
+		for (size_t i=0;i<files.size();i++)
+			if (listed.count(files[i])) kept.push_back(files[i]);
+		files.swap(kept);
+		return !touched.empty();
+	}
+
+	//----< parse the packages of the touched files again, keeping the other tables >--
+	// return whether the changed packages were parsed
+	bool reparse(const std::vector<std::string>& files, const std::vector<std::string>& touched, AnalysisCache& cache) {
+		std::unordered_set<std::string> packages;
+		for (size_t i=0;i<touched.size();i++)
+			packages.insert(SymbolTable::getPackageName(touched[i]));
+		// a package is parsed from all its files, changed or not, the cache replays the others
+		std::vector<std::string> toParse;
+		std::unordered_set<std::string> parsed;
+		for (size_t i=0;i<files.size();i++) {
+			std::string package = SymbolTable::getPackageName(files[i]);
+			if (packages.count(package)) {
+				toParse.push_back(files[i]);
+				parsed.insert(package);
+			}
+		}
+		std::vector<std::string> changed, removed;
+		for (std::unordered_set<std::string>::iterator it=packages.begin(); it!=packages.end(); it++)
+			(parsed.count(*it) ? changed : removed).push_back(*it);
+		symbols.update(changed, removed);
+		unapplied.insert(removed.begin(), removed.end());	// their vertices are removed with the next graph update
+		return toParse.empty() || FileManager::parse(toParse, &symbols, workers, &cache);
+	}
+
 	// graph instance
 	graph* pGraph;
+	searcher* pSearcher;	// strong components of the graph, 0 before the first analysis
+	std::unordered_set<std::string> unapplied;	// packages analyzed again or gone, whose edges the graph does not show yet
+	SymbolDatabase symbols;	// symbol tables of all parsed files
 	std::string path;
 	std::vector<std::string> patterns;
 	bool isRecursive;
+	size_t workers;	// number of parsing threads
+	std::string cacheFile;	// where parsed files are cached, empty for no cache
+	IgnoreRules rules;	// files and directories left out
+	bool hasFileList;	// files are given, path is not walked
+	std::vector<std::string> fileList;	// the given files
+
+	//----< the files to analyze, given or found under path >------------------
+	std::vector<std::string> listFiles() {
+		if (hasFileList) return DirectoryWalker::filter(fileList, rules);
+		return FileManager::getFileList(path, isRecursive, patterns, workers, &rules);
+	}
 public:
 
 	//----< promotional constructor >-----------------------------------
-	Analyzer(std::string _path, std::vector<std::string> _patterns, bool _isRecursive)
-		: path(_path), patterns(_patterns), isRecursive(_isRecursive) {
+	Analyzer(std::string _path, std::vector<std::string> _patterns, bool _isRecursive, size_t _workers=1, std::string _cacheFile="")
+		: pSearcher(0), path(_path), patterns(_patterns), isRecursive(_isRecursive), workers(_workers), cacheFile(_cacheFile), hasFileList(false) {
+			pGraph = new graph;
+	}
+	//----< constructor for a given list of files, nothing is walked >--------
+	Analyzer(std::vector<std::string> _files, size_t _workers=1, std::string _cacheFile="")
+		: pSearcher(0), isRecursive(false), workers(_workers), cacheFile(_cacheFile), hasFileList(true), fileList(_files) {
 			pGraph = new graph;
 	}
 	//----< destroctor, release resource >-----------------------------------
 	~Analyzer() {
+		delete pSearcher;
 		delete pGraph;
 	}
 
+	//----< leave out what the rules ignore, and what ignore files found in the walk ignore >---
+	// given files are matched as they are spelled, with the ignore files on their paths
+	void ignore(const std::vector<std::string>& excludes, const std::string& ignoreFile) {
+		for (size_t i=0;i<excludes.size();i++)
+			rules.add(excludes[i], path);	// anchored rules are relative to path, as in a .gitignore there
+		if (ignoreFile.empty()) return;
+		rules.ignoreFile(ignoreFile);
+		if (hasFileList) return;	// read by DirectoryWalker::filter()
+		std::string dir(path);
+		if (dir[dir.length()-1]!='/' && dir[dir.length()-1]!='\\')
+			dir += "/";
+		rules.read(dir+ignoreFile, dir);	// also for what watch() finds outside a walk of path
+	}
+
 	//----< the merely interface, do all work >-----------------------------------
 	void doWork() {
 		// the command line should be :  [option] path [file pattern] [file_pattern]
-		std::vector<std::string> files = FileManager::getFileList(path, isRecursive, patterns);
+		std::vector<std::string> files = listFiles();
+		std::cout<<"\n Now start analyzing.. Please be patient..\n";
+		AnalysisCache cache(cacheFile);
+		AnalysisCache* pCache = cacheFile.empty() ? 0 : &cache;
+		if (pCache) cache.load();
+		if (FileManager::parse(files, &symbols, workers, pCache)) {
+			if (pCache) {
+				std::cout<<"\n\n "<<cache.hits()<<" of "<<files.size()<<" files are unchanged since cached";
+				if (!cache.save()) std::cout<<"\n could not save cache "<<cacheFile;
+			}
+			analyzeSymbols();
+		}
+	}
+
+	//----< do all work, then again for every batch of changes under path >-------
+	void watch() {
+		std::vector<std::string> files = listFiles();
 		std::cout<<"\n Now start analyzing.. Please be patient..\n";
-		if (FileManager::parse(files)) {
-			std::cout<<"\n\n Searching for package dependency...";
-			SymbolTable::analyzeAll();
-			convertToGraph();
-			saveGraph();
-			std::cout<<"\n Graph has been save to ./graph.xml";
-			GraphLib::Display<std::string, std::string>::show(*pGraph);
-			std::cout<<"\n Now searching for strong components...";
-			GraphLib::SCCSearcher<std::string, std::string> searcher(pGraph);
-			searcher.search();
-			std::cout<<"\n Sorting strong components...";
-			GraphLib::SCCSorter<std::string, size_t> sorter(&searcher.Graph());
-			sorter.sort();
-			// output sorted strong components
-			sorter.show();
-			std::cout<<"\n\n Done!! All relationship has been analyzed.\n";
+		AnalysisCache cache(cacheFile);	// holds the facts of every file, so only changed files are parsed again
+		if (!cacheFile.empty()) cache.load();
+		if (!FileManager::parse(files, &symbols, workers, &cache)) return;
+		analyzeSymbols();
+		if (hasFileList) {	// a build which lists its files runs again itself
+			std::cout<<"\n Watching needs a path to walk, not a list of files\n";
+			return;
+		}
+		if (!DirectoryWatcher::isSupported()) {
+			std::cout<<"\n Watching is not supported on this platform\n";
+			return;
+		}
+		DirectoryWatcher watcher;
+		watchDirectory(watcher, path);
+		std::vector<DirectoryWatcher::Change> changes;
+		std::vector<std::string> touched;
+		for (;;) {
+			if (!cacheFile.empty() && !cache.save()) std::cout<<"\n could not save cache "<<cacheFile;
+			std::cout<<"\n Watching "<<watcher.size()<<" directories for changes..\n"<<std::flush;
+			touched.clear();
+			do {
+				if (!watcher.wait(changes)) return;
+			} while (!applyChanges(watcher, changes, files, cache, touched));
+			// parse the packages of the changed files again, and analyze what they affect
+			analyzeChanges(reparse(files, touched, cache));
 		}
 	}
 };
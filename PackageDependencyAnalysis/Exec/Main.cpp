@@ -23,7 +23,7 @@ Maintanence Information:
 ========================
 Required files:
 ---------------
-Analyzer.h
+Analyzer.h, CompileCommands.h
 
 Build Process:
 --------------
@@ -32,13 +32,22 @@ devenv PackageDependencyAnalysis.sln /rebuild debug
 
 Revision History:
 -----------------
+- ver 0.7 the files and include directories can be taken from a compile_commands.json
+- ver 0.6 the files can be listed in @<file>, or on standard input with -
+- ver 0.5 added \X=<rule> and \G options for leaving files out
+- ver 0.4 added \W option for watch mode
+- ver 0.3 added \C and \C=<file> options for the analysis cache
+- ver 0.2 added \J<n> option for multi-threaded parsing
 - ver 0.1 first version
 
 */
 
 #include <iostream>
 #include <string>
+#include <cstdlib>
+#include <thread>
 #include "Analyzer.h"
+#include "CompileCommands.h"
 
 ///////////////////////////////////////////////////////////////
 // main entry point of the program
@@ -48,23 +57,83 @@ int main(int argc, char* argv[])
 	try {
 		std::cout << "\nPackage Dependency Analysis starts! - by Kevin Wang"<< std::string(10,' ')<<"\nfor Spring 2013, Pr#2"<< std::endl;
 		bool isRecursive = false;
-		if (argc>1) isRecursive=(std::string(argv[1])=="\\R");
+		bool isWatching = false;
+		size_t workers = 1;
+		std::string cacheFile;
+		std::vector<std::string> excludes;
+		std::string ignoreFile;
+		int argi = 1;
+		// read options, \R for recursive search, \J<n> for parsing with n threads,
+		// \C or \C=<file> for keeping what was parsed in a cache file, analysis.cache by default,
+		// \W for analyzing again whenever files under the path change,
+		// \X=<rule> for leaving out what a .gitignore rule matches, \G for following .gitignore files,
+		// also for files which are listed or taken from a compilation database
+		for (;argi<argc;argi++) {
+			std::string opt(argv[argi]);
+			if (opt=="\\R") isRecursive = true;
+			else if (opt=="\\W") isWatching = true;
+			else if (opt=="\\C") cacheFile = "analysis.cache";
+			else if (opt.substr(0,3)=="\\C=" && opt.length()>3) cacheFile = opt.substr(3);
+			else if (opt.substr(0,3)=="\\X=" && opt.length()>3) excludes.push_back(opt.substr(3));
+			else if (opt=="\\G") ignoreFile = ".gitignore";
+			else if (opt.substr(0,2)=="\\J" && opt.find_first_not_of("0123456789",2)==std::string::npos) {
+				workers = (opt.length()>2) ? std::strtoul(opt.c_str()+2, 0, 10) : std::thread::hardware_concurrency();
+				if (workers<1) workers = 1;
+			}
+			else break;	// not an option, this is the path
+		}
 		// see if command arguments are valid
-		if(argc < 2 || (isRecursive && argc<3)) {
+		if(argi >= argc) {
 			std::cout<< "\n  please enter name of file to process on command line\n\n";
 			return 1;
 		}
 		std::vector<std::string> patterns;
-		std::string path = isRecursive ? argv[2] : argv[1];
+		std::string path = argv[argi];
+		// @<file> or - instead of the path gives the files themselves, one per line or NUL separated
+		if (path=="-" || (path[0]=='@' && path.length()>1)) {
+			std::vector<std::string> files;
+			bool isRead = (path=="-") ? FileManager::readFileList(std::cin, files) : FileManager::readFileList(path.substr(1), files);
+			if (!isRead) {
+				std::cout<< "\n  could not read the list of files " << path << "\n\n";
+				return 1;
+			}
+			Analyzer anal(files, workers, cacheFile);
+			anal.ignore(excludes, ignoreFile);
+			if (isWatching) anal.watch();
+			else anal.doWork();
+			return 0;
+		}
+		// a .json path is a compilation database: its units and the headers under its include
+		// directories, subdirectories included, matching the patterns, *.h, *.hpp, *.hh and *.hxx
+		// by default, are parsed, nothing in its system include directories is
+		if (path.length()>5 && path.compare(path.length()-5, 5, ".json")==0) {
+			CompileCommands commands;
+			if (!commands.load(path)) {
+				std::cout<< "\n  could not read the compilation database " << path << "\n\n";
+				return 1;
+			}
+			for (int i=argi+1; i<argc; ++i) patterns.push_back(argv[i]);
+			if (patterns.empty()) {
+				const char* headers[] = { "*.h", "*.hpp", "*.hh", "*.hxx" };
+				patterns.assign(headers, headers+4);
+			}
+			Analyzer anal(commands.sourceFiles(patterns), workers, cacheFile);
+			anal.ignore(excludes, ignoreFile);
+			if (isWatching) anal.watch();
+			else anal.doWork();
+			return 0;
+		}
 		// get all patterns
-		for (int i=isRecursive ? 3 : 2; i<argc; ++i) patterns.push_back(argv[i]);
+		for (int i=argi+1; i<argc; ++i) patterns.push_back(argv[i]);
 		if (patterns.size()<1) {	// no value is specific
 			patterns.push_back("*.h");
 			patterns.push_back("*.cpp");
 		}
 		// start analyze
-		Analyzer anal(path, patterns, isRecursive);
-		anal.doWork();
+		Analyzer anal(path, patterns, isRecursive, workers, cacheFile);
+		anal.ignore(excludes, ignoreFile);
+		if (isWatching) anal.watch();
+		else anal.doWork();
 	}
 	catch (std::exception& ex) {
 		std::cout << "\n\n    " << ex.what() << "\n\n";
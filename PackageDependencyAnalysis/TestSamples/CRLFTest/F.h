@@ -0,0 +1,13 @@
+// This file is saved with CRLF line ends on purpose.
+// Every line ends in a brace or semicolon, which must still
+// reach the parser as a token.
+
+#ifndef F_H
+#define F_H
+
+class F {
+public:
+	void doNothing();
+};
+
+#endif
@@ -0,0 +1,8 @@
+// This file is saved with CRLF line ends on purpose.
+
+#include "F.h"
+
+// G inherits F and aggregates F
+class G: public F {
+	F* f;
+};
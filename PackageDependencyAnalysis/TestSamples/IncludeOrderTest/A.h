@@ -0,0 +1,3 @@
+#include "Q.h"
+
+class A {};
@@ -0,0 +1,3 @@
+#include "C.h"
+
+class B {};
@@ -0,0 +1,2 @@
+// defines T, as Q.h does
+class T {};
@@ -0,0 +1,2 @@
+// defines T, as C.h does
+class T {};
@@ -0,0 +1,10 @@
+// X uses T, which both Q.h and C.h define.  Q.h is included through A.h and
+// C.h through B.h; A.h is included first, so its includes are searched first
+// and X should depend on Q, whatever order the files are parsed in.
+
+#include "A.h"
+#include "B.h"
+
+class X {
+	T* t;
+};
@@ -0,0 +1,406 @@
+//////////////////////////////////////////////////////////////////////////
+//	CompileCommands.cpp - Reads the files and include directories of a	//
+//	build from its compile_commands.json								//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Package Operations:
+===================
+Implements CompileCommands and its JSON reader, and tests them
+
+Public Interface:
+=================
+none
+
+Maintanence Information:
+========================
+Required files:
+---------------
+CompileCommands.h, DirectoryWalker.h, DirectoryWalker.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.2 : include directories are walked with their subdirectories.
+- ver 0.1 : initial version.
+
+*/
+#include <fstream>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include "CompileCommands.h"
+#include "DirectoryWalker.h"
+
+///////////////////////////////////////////////////////////////
+// pulls the values of a JSON text from a stream buffer, one at a time
+class JsonReader {
+public:
+	explicit JsonReader(std::streambuf* pBuffer) : _pBuffer(pBuffer) {}
+
+	// next character after white space, eof() at the end
+	int peek() {
+		int c;
+		while ((c = _pBuffer->sgetc())==' ' || c=='\t' || c=='\n' || c=='\r')
+			_pBuffer->sbumpc();
+		return c;
+	}
+
+	// take c if it comes next
+	bool accept(char c) {
+		if (peek()!=c) return false;
+		_pBuffer->sbumpc();
+		return true;
+	}
+
+	// read a string value
+	bool readString(std::string& value) {
+		value.clear();
+		if (!accept('"')) return false;
+		for (;;) {
+			int c = _pBuffer->sbumpc();
+			if (c==eof() || c=='\n') return false;
+			if (c=='"') return true;
+			if (c!='\\') {
+				value += (char)c;
+				continue;
+			}
+			switch (c = _pBuffer->sbumpc()) {
+			case '"': case '\\': case '/': value += (char)c; break;
+			case 'b': value += '\b'; break;
+			case 'f': value += '\f'; break;
+			case 'n': value += '\n'; break;
+			case 'r': value += '\r'; break;
+			case 't': value += '\t'; break;
+			case 'u': if (!readCodePoint(value)) return false; break;
+			default: return false;
+			}
+		}
+	}
+
+	// read an array of strings
+	bool readStrings(std::vector<std::string>& values) {
+		values.clear();
+		if (!accept('[')) return false;
+		if (accept(']')) return true;
+		do {
+			values.push_back(std::string());
+			if (!readString(values.back())) return false;
+		} while (accept(','));
+		return accept(']');
+	}
+
+	// read over any value
+	bool skipValue() {
+		std::string s;
+		int c = peek();
+		if (c=='"') return readString(s);
+		if (c=='{' || c=='[') {
+			char close = (c=='{') ? '}' : ']';
+			_pBuffer->sbumpc();
+			if (accept(close)) return true;
+			do {
+				if (close=='}' && (!readString(s) || !accept(':'))) return false;
+				if (!skipValue()) return false;
+			} while (accept(','));
+			return accept(close);
+		}
+		size_t n = 0;	// number, true, false or null
+		while ((c = _pBuffer->sgetc())!=eof() && (isalnum(c) || c=='-' || c=='+' || c=='.')) {
+			_pBuffer->sbumpc();
+			n++;
+		}
+		return n>0;
+	}
+
+	static int eof() { return std::char_traits<char>::eof(); }
+
+private:
+	std::streambuf* _pBuffer;
+
+	// read the 4 hex digits after \u
+	bool readHex(unsigned& code) {
+		code = 0;
+		for (int i=0;i<4;i++) {
+			int c = _pBuffer->sbumpc();
+			if (!isxdigit(c)) return false;
+			code = code*16 + (isdigit(c) ? c-'0' : (tolower(c)-'a'+10));
+		}
+		return true;
+	}
+
+	// read a \u escape, and the low surrogate after a high one, into UTF-8
+	bool readCodePoint(std::string& value) {
+		unsigned code, low;
+		if (!readHex(code)) return false;
+		if (code>=0xD800 && code<0xDC00) {
+			if (_pBuffer->sbumpc()!='\\' || _pBuffer->sbumpc()!='u' || !readHex(low) || low<0xDC00 || low>=0xE000)
+				return false;
+			code = 0x10000 + ((code-0xD800)<<10) + (low-0xDC00);
+		}
+		if (code<0x80)
+			value += (char)code;
+		else if (code<0x800) {
+			value += (char)(0xC0 | (code>>6));
+			value += (char)(0x80 | (code&0x3F));
+		}
+		else if (code<0x10000) {
+			value += (char)(0xE0 | (code>>12));
+			value += (char)(0x80 | ((code>>6)&0x3F));
+			value += (char)(0x80 | (code&0x3F));
+		}
+		else {
+			value += (char)(0xF0 | (code>>18));
+			value += (char)(0x80 | ((code>>12)&0x3F));
+			value += (char)(0x80 | ((code>>6)&0x3F));
+			value += (char)(0x80 | (code&0x3F));
+		}
+		return true;
+	}
+};
+
+//----< whether path is absolute >-----------------------------------------
+
+static bool isAbsolute(const std::string& path) {
+	return !path.empty() && (path[0]=='/' || path[0]=='\\' || (path.length()>1 && path[1]==':'));
+}
+
+//----< path relative to directory >---------------------------------------
+
+static std::string join(const std::string& directory, const std::string& path) {
+	if (directory.empty() || isAbsolute(path)) return path;
+	if (path.empty()) return directory;
+	char last = directory[directory.length()-1];
+	return (last=='/' || last=='\\') ? directory + path : directory + "/" + path;
+}
+
+//----< directory part of path, "." for a bare name >----------------------
+
+static std::string directoryOf(const std::string& path) {
+	size_t pos = path.find_last_of("/\\");
+	if (pos==std::string::npos) return ".";
+	return path.substr(0, pos ? pos : 1);
+}
+
+//----< read a compilation database file >---------------------------------
+
+bool CompileCommands::load(const std::string& file) {
+	std::ifstream in(file.c_str(), std::ios::binary);
+	return in.good() && load(in);
+}
+
+//----< read a compilation database, one entry at a time >-----------------
+
+bool CompileCommands::load(std::istream& in) {
+	JsonReader json(in.rdbuf());
+	if (!json.accept('[')) return false;
+	if (json.accept(']')) return true;
+	std::string key, directory, file, command;
+	std::vector<std::string> arguments;
+	do {
+		if (!json.accept('{')) return false;
+		directory.clear();
+		file.clear();
+		command.clear();
+		arguments.clear();
+		if (!json.accept('}')) {
+			do {
+				if (!json.readString(key) || !json.accept(':')) return false;
+				bool isRead;
+				if (key=="directory") isRead = json.readString(directory);
+				else if (key=="file") isRead = json.readString(file);
+				else if (key=="command") isRead = json.readString(command);
+				else if (key=="arguments") isRead = json.readStrings(arguments);
+				else isRead = json.skipValue();
+				if (!isRead) return false;
+			} while (json.accept(','));
+			if (!json.accept('}')) return false;
+		}
+		if (arguments.empty() && !command.empty())
+			arguments = splitCommand(command);
+		if (!file.empty())
+			add(directory, file, arguments);
+	} while (json.accept(','));
+	return json.accept(']');
+}
+
+//----< keep the unit and the include directories of one entry >----------
+
+void CompileCommands::add(const std::string& directory, const std::string& file, const std::vector<std::string>& arguments) {
+	keep(_units, join(directory, file));
+	static const char* userFlags[] = { "-I", "-iquote", "/I" };
+	static const char* systemFlags[] = { "-isystem", "-idirafter", "-imsvc", "-external:I", "/external:I" };
+	// only cl and clang-cl take flags starting with '/', elsewhere /I... is a path
+	bool isMsvc = false;
+	if (!arguments.empty()) {
+		std::string driver = arguments[0].substr(arguments[0].find_last_of("/\\")+1);
+		std::transform(driver.begin(), driver.end(), driver.begin(), ::tolower);
+		if (driver.length()>4 && driver.compare(driver.length()-4, 4, ".exe")==0)
+			driver.erase(driver.length()-4);
+		isMsvc = (driver=="cl" || driver=="clang-cl");
+	}
+	for (size_t i=1;i<arguments.size();i++) {
+		const std::string& arg = arguments[i];
+		if (arg[0]=='/' && !isMsvc) continue;
+		std::vector<std::string>* pList = 0;
+		size_t length = 0;
+		for (size_t k=0;!pList && k<sizeof(systemFlags)/sizeof(systemFlags[0]);k++)
+			if (arg.compare(0, length = strlen(systemFlags[k]), systemFlags[k])==0) pList = &_systems;
+		for (size_t k=0;!pList && k<sizeof(userFlags)/sizeof(userFlags[0]);k++)
+			if (arg.compare(0, length = strlen(userFlags[k]), userFlags[k])==0) pList = &_includes;
+		if (!pList) continue;
+		std::string dir = arg.substr(length);
+		if (dir.empty() && i+1<arguments.size())	// directory in the next argument
+			dir = arguments[++i];
+		if (!dir.empty())
+			keep(*pList, join(directory, dir));
+	}
+}
+
+//----< keep path in list unless it was kept before >----------------------
+
+void CompileCommands::keep(std::vector<std::string>& list, const std::string& path) {
+	if (_listed.insert(path).second)
+		list.push_back(path);
+}
+
+//----< whether path is in a system directory >----------------------------
+
+bool CompileCommands::isSystem(const std::string& path) const {
+	return isUnder(path, _systems);
+}
+
+//----< whether path is one of directories or under one of them >----------
+
+bool CompileCommands::isUnder(const std::string& path, const std::vector<std::string>& directories) {
+	for (size_t i=0;i<directories.size();i++) {
+		const std::string& dir = directories[i];
+		if (path.compare(0, dir.length(), dir)!=0) continue;
+		if (path.length()==dir.length()) return true;
+		char next = path[dir.length()], last = dir[dir.length()-1];
+		if (next=='/' || next=='\\' || last=='/' || last=='\\') return true;
+	}
+	return false;
+}
+
+//----< headers of the build's own directories, then the units >-----------
+// the directories are walked with their subdirectories, as includes such as
+// "detail/x.h" name headers below them; system directories below one are
+// pruned from the walk, and a directory below one walked before is not
+// walked again
+
+std::vector<std::string> CompileCommands::sourceFiles(const std::vector<std::string>& headerPatterns) const {
+	std::vector<std::string> directories(_includes);
+	for (size_t i=0;i<_units.size();i++)	// "" includes are looked up beside the unit first
+		directories.push_back(directoryOf(_units[i]));
+	IgnoreRules rules;	// an anchored rule for each system directory, relative to the directory above it
+	for (size_t i=0;i<_systems.size();i++) {
+		std::string dir = _systems[i];
+		while (dir.length()>1 && (dir[dir.length()-1]=='/' || dir[dir.length()-1]=='\\'))
+			dir.erase(dir.length()-1);
+		size_t pos = dir.find_last_of("/\\");
+		if (pos==std::string::npos) rules.add("/"+dir+"/");
+		else if (pos+1<dir.length()) rules.add("/"+dir.substr(pos+1)+"/", dir.substr(0, pos+1));
+	}
+	std::unordered_set<std::string> listed;
+	std::vector<std::string> walked, files;
+	for (size_t i=0;i<directories.size();i++) {
+		if (isSystem(directories[i]) || isUnder(directories[i], walked) || !listed.insert(directories[i]).second) continue;
+		walked.push_back(directories[i]);
+		std::vector<std::string> headers = DirectoryWalker::walk(directories[i], true, headerPatterns, 1, &rules);
+		for (size_t k=0;k<headers.size();k++)
+			if (!isSystem(headers[k]) && listed.insert(headers[k]).second) files.push_back(headers[k]);
+	}
+	for (size_t i=0;i<_units.size();i++)
+		if (!isSystem(_units[i]) && listed.insert(_units[i]).second)
+			files.push_back(_units[i]);
+	return files;
+}
+
+//----< split a command line as a POSIX shell does >-----------------------
+
+std::vector<std::string> CompileCommands::splitCommand(const std::string& command) {
+	std::vector<std::string> args;
+	std::string arg;
+	bool isInArg = false;
+	char quote = 0;	// ' or " while inside quotes
+	for (size_t i=0;i<command.length();i++) {
+		char c = command[i];
+		if (quote=='\'') {	// nothing is special inside '...'
+			if (c=='\'') quote = 0;
+			else arg += c;
+		}
+		else if (c=='\\' && i+1<command.length() && (!quote || command[i+1]=='"' || command[i+1]=='\\')) {
+			arg += command[++i];
+			isInArg = true;
+		}
+		else if (quote=='"') {
+			if (c=='"') quote = 0;
+			else arg += c;
+		}
+		else if (c=='\'' || c=='"') {
+			quote = c;
+			isInArg = true;
+		}
+		else if (c==' ' || c=='\t' || c=='\n' || c=='\r') {
+			if (isInArg) args.push_back(arg);
+			arg.clear();
+			isInArg = false;
+		}
+		else {
+			arg += c;
+			isInArg = true;
+		}
+	}
+	if (isInArg) args.push_back(arg);
+	return args;
+}
+
+#ifdef TEST_COMPILECOMMANDS
+
+#include <iostream>
+#include <sstream>
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing CompileCommands\n ";
+	std::vector<std::string> args = CompileCommands::splitCommand("g++ -I\"my dir\" -D'A=\"x y\"' a\\ b.cpp");
+	for (size_t i=0;i<args.size();i++)
+		std::cout << "\n argument [" << args[i] << "]";
+	std::istringstream in(
+		"[ { \"directory\": \"/src\", \"file\": \"a.cpp\", \"output\": null,\n"
+		"    \"command\": \"c++ -Iinc -I /abs -isystem /usr/local/include -c a.cpp\" },\n"
+		"  { \"directory\": \"/src\", \"file\": \"/src/b\\u00e9.cpp\", \"extra\": {\"k\": [1, 2.5e3, true]},\n"
+		"    \"arguments\": [\"c++\", \"-iquote\", \"inc\", \"-c\", \"b.cpp\"] },\n"
+		"  { \"directory\": \"/src\", \"file\": \"/Include/c.cpp\", \"command\": \"g++ -c /Include/c.cpp\" },\n"
+		"  { \"directory\": \"C:/src\", \"file\": \"d.cpp\", \"command\": \"CL.EXE /Iwin /c d.cpp\" } ]");
+	CompileCommands commands;
+	std::cout << "\n loaded: " << commands.load(in);
+	for (size_t i=0;i<commands.translationUnits().size();i++)
+		std::cout << "\n unit " << commands.translationUnits()[i];
+	for (size_t i=0;i<commands.includeDirectories().size();i++)
+		std::cout << "\n include " << commands.includeDirectories()[i];
+	for (size_t i=0;i<commands.systemDirectories().size();i++)
+		std::cout << "\n system " << commands.systemDirectories()[i];
+	std::istringstream broken("[ { \"file\": \"a.cpp\" ");
+	std::cout << "\n broken database loaded: " << CompileCommands().load(broken);
+	if (argc>1) {
+		CompileCommands file;
+		std::cout << "\n " << argv[1] << " loaded: " << file.load(argv[1]);
+		std::vector<std::string> patterns(1, "*.h");
+		std::cout << "\n " << file.sourceFiles(patterns).size() << " files to parse, "
+			<< file.systemDirectories().size() << " system directories left out";
+	}
+	std::cout << "\n\n";
+}
+#endif
@@ -0,0 +1,124 @@
+#ifndef COMPILECOMMANDS_H
+#define COMPILECOMMANDS_H
+
+//////////////////////////////////////////////////////////////////////////
+//	CompileCommands.h - Reads the files and include directories of a	//
+//	build from its compile_commands.json								//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+CompileCommands reads a JSON compilation database, as written by CMake or
+Bear, so an analysis parses the files of the real build instead of walking
+a directory.  Every entry gives the translation unit in "file", the
+directory the compiler ran in, and the command line, either as one string
+in "command", split as a POSIX shell would, or as an "arguments" array.
+Relative paths are taken relative to the directory of their entry.
+
+From the command lines it collects the include directories: -I, -iquote
+and /I directories are the build's own, -isystem, -idirafter, -imsvc and
+-external:I directories are system directories.  Flags starting with '/'
+are taken only from cl and clang-cl command lines; for other compilers
+such an argument is a path, e.g. a source file under /Include.  Every
+translation unit and directory is kept once, in the order first met.
+
+The file is read by a streaming JSON reader straight from the stream
+buffer: only the entry being read is held in memory, so a database of
+many thousands of entries is not built up as a document first.
+
+sourceFiles() gives what to parse: the headers in the build's include
+directories and in the directories of the translation units, and in their
+subdirectories, then the translation units, leaving out anything in a
+system directory.  A system directory below an include directory is not
+walked.  Headers in system directories are thus never parsed, and the
+includes naming them stay outside the analysis.
+
+Public Interface:
+=================
+CompileCommands commands;
+if (commands.load("build/compile_commands.json")) {
+	const std::vector<std::string>& units = commands.translationUnits();
+	const std::vector<std::string>& dirs = commands.includeDirectories();
+	const std::vector<std::string>& sysDirs = commands.systemDirectories();
+	std::vector<std::string> files = commands.sourceFiles(headerPatterns);
+}
+bool res = commands.load(std::cin);
+std::vector<std::string> args = CompileCommands::splitCommand("g++ -I\"my dir\" -c a.cpp");
+
+Maintanence Information:
+========================
+Required files:
+---------------
+CompileCommands.h, CompileCommands.cpp, DirectoryWalker.h, DirectoryWalker.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.2 include directories are walked with their subdirectories
+- ver 0.1 first version
+
+*/
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <istream>
+
+///////////////////////////////////////////////////////////////
+// CompileCommands class
+class CompileCommands {
+public:
+	CompileCommands() {}
+
+	// read a compilation database file, return whether it is one
+	bool load(const std::string& file);
+
+	// read a compilation database from a stream, return whether it is one
+	bool load(std::istream& in);
+
+	// translation units, in database order
+	const std::vector<std::string>& translationUnits() const { return _units; }
+
+	// directories given by -I, -iquote and /I
+	const std::vector<std::string>& includeDirectories() const { return _includes; }
+
+	// directories given by -isystem, -idirafter, -imsvc and -external:I
+	const std::vector<std::string>& systemDirectories() const { return _systems; }
+
+	// headers under the include directories and the directories of the units, then the units
+	std::vector<std::string> sourceFiles(const std::vector<std::string>& headerPatterns) const;
+
+	// add one entry of the database
+	void add(const std::string& directory, const std::string& file, const std::vector<std::string>& arguments);
+
+	// split a command line into its arguments, as a POSIX shell does
+	static std::vector<std::string> splitCommand(const std::string& command);
+
+private:
+	std::vector<std::string> _units;
+	std::vector<std::string> _includes;
+	std::vector<std::string> _systems;
+	std::unordered_set<std::string> _listed;	// units and directories kept so far
+
+	// whether path is in a system directory
+	bool isSystem(const std::string& path) const;
+
+	// whether path is one of directories or under one of them
+	static bool isUnder(const std::string& path, const std::vector<std::string>& directories);
+
+	// keep path in list unless it was kept before
+	void keep(std::vector<std::string>& list, const std::string& path);
+};
+
+#endif
@@ -0,0 +1,535 @@
+//////////////////////////////////////////////////////////////////////////
+//	DirectoryWalker.cpp - Lists the files of a directory tree, walking	//
+//	subdirectories in parallel											//
+//																		//
+//	ver 0.5																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Package Operations:
+===================
+Implements DirectoryWalker, and tests it
+
+Public Interface:
+=================
+none
+
+Maintanence Information:
+========================
+Required files:
+---------------
+DirectoryWalker.h, FileSystem.h, FileSystem.cpp (Windows)
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.5 : a directory reached twice through links is walked once.
+- ver 0.4 : added filter().
+- ver 0.3 : added IgnoreRules, links back up the tree are not walked.
+- ver 0.2 : added PatternSet, one walk for all patterns.
+- ver 0.1 : initial version.
+
+*/
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <set>
+#include <map>
+#include <fstream>
+#include <cstring>
+#include <cctype>
+#include "DirectoryWalker.h"
+#ifdef _WIN32
+#include "FileSystem.h"
+#else
+#include <dirent.h>
+#include <fnmatch.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+//----< name compared as the file system compares names >-----------------
+
+static std::string foldCase(std::string name) {
+#ifdef _WIN32
+	for (size_t i=0;i<name.length();i++)
+		name[i] = (char)tolower((unsigned char)name[i]);
+#endif
+	return name;
+}
+
+//----< constructor, sort patterns by how they are matched >---------------
+
+PatternSet::PatternSet(const std::vector<std::string>& patterns) : _patterns(patterns), _all(-1) {
+	for (size_t i=0;i<_patterns.size();i++) {
+		const std::string& pattern = _patterns[i];
+		if (pattern=="*" || pattern=="*.*") {	// *.* means every file, as on Windows
+			if (_all<0) _all = (int)i;
+		}
+		else if (pattern.length()>2 && pattern.compare(0, 2, "*.")==0 && pattern.find_first_of("*?[.", 2)==std::string::npos)
+			_extensions.insert(std::make_pair(foldCase(pattern.substr(2)), (int)i));	// keeps the first of equal ones
+		else
+			_globs.push_back((int)i);
+	}
+}
+
+//----< index of the first pattern matching name >-------------------------
+
+int PatternSet::match(const char* name) const {
+	int first = _all;
+	const char* dot = _extensions.empty() ? 0 : strrchr(name, '.');
+	if (dot) {
+		std::unordered_map<std::string, int>::const_iterator it = _extensions.find(foldCase(dot+1));
+		if (it!=_extensions.end() && (first<0 || it->second<first))
+			first = it->second;
+	}
+	for (size_t i=0;i<_globs.size() && (first<0 || _globs[i]<first);i++)
+		if (glob(_patterns[_globs[i]], name))
+			first = _globs[i];
+	return first;
+}
+
+#ifdef _WIN32
+
+//----< match * and ? wildcards, ignoring case >---------------------------
+
+bool PatternSet::glob(const std::string& pattern, const char* name) {
+	const char* p = pattern.c_str();
+	const char* star = 0;	// last * seen, and the name it was tried against
+	const char* resume = 0;
+	while (*name) {
+		if (*p=='*') {
+			star = p++;
+			resume = name;
+		}
+		else if (*p=='?' || (*p && tolower((unsigned char)*p)==tolower((unsigned char)*name))) {
+			p++;
+			name++;
+		}
+		else if (star) {	// let the last * take one more character
+			p = star+1;
+			name = ++resume;
+		}
+		else
+			return false;
+	}
+	while (*p=='*') p++;
+	return *p==0;
+}
+
+#else
+
+bool PatternSet::glob(const std::string& pattern, const char* name) {
+	return fnmatch(pattern.c_str(), name, 0)==0;
+}
+
+#endif
+
+//----< split path into its names, at any of the separators >-------------
+
+static void split(const std::string& path, const char* separators, std::vector<std::string>& names) {
+	names.clear();
+	size_t begin = 0;
+	for (size_t i=0;i<=path.length();i++)
+		if (i==path.length() || strchr(separators, path[i])) {
+			if (i>begin) names.push_back(path.substr(begin, i-begin));
+			begin = i+1;
+		}
+}
+
+//----< add a rule in .gitignore syntax >----------------------------------
+
+void IgnoreRules::add(const std::string& rule, const std::string& directory) {
+	std::string line(rule);
+	while (!line.empty() && (line.back()=='\r' || line.back()==' ' || line.back()=='\t'))
+		line.pop_back();
+	if (line.empty() || line[0]=='#') return;	// blank line or comment
+	Rule r;
+	r.isNegated = line[0]=='!';
+	if (r.isNegated) line.erase(0, 1);
+	else if (line[0]=='\\') line.erase(0, 1);	// \# and \! stand for themselves
+	r.isDirectoryOnly = !line.empty() && line.back()=='/';
+	if (r.isDirectoryOnly) line.pop_back();
+	r.isAnchored = line.find('/')!=std::string::npos;
+	split(line, "/", r.names);
+	if (r.names.empty()) return;
+	r.directory = directory;
+	if (!r.directory.empty() && r.directory.back()!='/' && r.directory.back()!='\\')
+		r.directory += "/";
+	std::vector<std::string> names;
+	split(r.directory, "/\\", names);
+	r.depth = names.size();
+	_rules.push_back(r);
+}
+
+//----< add the rules of an ignore file >----------------------------------
+
+bool IgnoreRules::read(const std::string& file, const std::string& directory) {
+	std::ifstream in(file.c_str());
+	if (!in.good()) return false;
+	std::string line;
+	while (std::getline(in, line))
+		add(line, directory);
+	return true;
+}
+
+//----< whether the last rule matching path ignores it >-------------------
+
+bool IgnoreRules::ignored(const std::string& path, bool isDirectory) const {
+	std::vector<std::string> names;
+	split(path, "/\\", names);
+	for (size_t i=_rules.size();i-->0;) {
+		const Rule& r = _rules[i];
+		if ((r.isDirectoryOnly && !isDirectory) || names.size()<=r.depth || path.compare(0, r.directory.length(), r.directory)!=0)
+			continue;
+		bool isMatch = r.isAnchored ? match(r.names, 0, names, r.depth) : PatternSet::glob(r.names[0], names.back().c_str());
+		if (isMatch) return !r.isNegated;
+	}
+	return false;
+}
+
+//----< whether path[s..] matches names[n..], ** matching any number of names >--
+
+bool IgnoreRules::match(const std::vector<std::string>& names, size_t n, const std::vector<std::string>& path, size_t s) {
+	if (n==names.size()) return s==path.size();
+	if (names[n]=="**") {
+		for (size_t k=s;k<=path.size();k++)
+			if (match(names, n+1, path, k)) return true;
+		return false;
+	}
+	return s<path.size() && PatternSet::glob(names[n], path[s].c_str()) && match(names, n+1, path, s+1);
+}
+
+///////////////////////////////////////////////////////////////
+// state of one walk, shared by its worker threads
+class TreeWalk {
+public:
+	static const size_t none = (size_t)-1;	// parent of the root
+
+	TreeWalk(const PatternSet& patterns, bool isRecursive) : _patterns(patterns), _isRecursive(isRecursive), _busy(0) {}
+
+	// queue a directory, path ending with a separator, as the next subdirectory of parent
+	void add(const std::string& path, size_t parent, const IgnoreRules* pRules) {
+		_nodes.push_back(Node());
+		_nodes.back().path = path;
+		_nodes.back().parent = parent;
+		_nodes.back().index = 0;
+		_nodes.back().pRules = pRules;
+		_nodes.back().device = _nodes.back().inode = 0;
+		_nodes.back().isDropped = false;
+		if (parent!=none) {
+			_nodes.back().index = _nodes[parent].children.size();
+			_nodes[parent].children.push_back(_nodes.size()-1);
+		}
+		_queue.push_back(_nodes.size()-1);
+	}
+
+	// list queued directories until there are none left and no worker is busy
+	void work() {
+		std::unique_lock<std::mutex> lock(_lock);
+		for (;;) {
+			while (_queue.empty() && _busy>0)
+				_ready.wait(lock);
+			if (_queue.empty()) break;	// nothing queued and nothing being listed, walk is done
+			size_t n = _queue.front();
+			_queue.pop_front();
+			_busy++;
+			std::string path = _nodes[n].path;
+			const IgnoreRules* pRules = _nodes[n].pRules;
+			lock.unlock();
+			DirectoryWalker::Listing listing;
+			DirectoryWalker::list(path, _patterns, listing, pRules ? pRules->ignoreFile() : std::string());
+			IgnoreRules rules;
+			if (listing.hasIgnoreFile) {	// its rules hold for this directory and below
+				rules = *pRules;
+				rules.read(path + pRules->ignoreFile(), path);
+				pRules = &rules;
+			}
+			if (pRules && !pRules->empty())
+				prune(path, *pRules, listing);
+			lock.lock();
+			if (listing.hasIgnoreFile) {
+				_rules.push_back(rules);
+				pRules = &_rules.back();
+			}
+			_nodes[n].device = listing.device;
+			_nodes[n].inode = listing.inode;
+			if (claim(n)) {
+				for (size_t i=0;i<listing.files.size();i++)
+					_nodes[n].files.push_back(path + listing.files[i]);
+				_nodes[n].matched.swap(listing.matched);
+				for (size_t i=0;_isRecursive && i<listing.directories.size();i++)
+					add(path + listing.directories[i] + "/", n, pRules);
+			}
+			_busy--;
+			_ready.notify_all();
+		}
+	}
+
+	// append the files of node and, depth first, of its subdirectories, which first match pattern
+	void collect(size_t n, int pattern, std::vector<std::string>& files) const {
+		const Node& node = _nodes[n];
+		for (size_t i=0;i<node.files.size();i++)
+			if (node.matched[i]==pattern)
+				files.push_back(node.files[i]);
+		for (size_t i=0;i<node.children.size();i++)
+			collect(node.children[i], pattern, files);
+	}
+
+private:
+	///////////////////////////////////////////////////////////////
+	// one directory of the walk
+	struct Node {
+		std::string path;	// ending with a separator
+		size_t parent;	// node of the directory above, none for the root
+		size_t index;	// position among the subdirectories of parent
+		const IgnoreRules* pRules;	// rules for this directory, may be null
+		unsigned long long device, inode;	// of this directory, 0 where unknown
+		std::vector<std::string> files;	// matching files, with path
+		std::vector<int> matched;	// first pattern matched by each file
+		std::vector<size_t> children;	// nodes of subdirectories, in listing order
+		bool isDropped;	// its directory is walked by another node
+	};
+	typedef std::pair<unsigned long long, unsigned long long> DirectoryId;	// device and inode
+
+	const PatternSet& _patterns;
+	bool _isRecursive;
+	std::deque<Node> _nodes;	// node 0 is the root
+	std::deque<IgnoreRules> _rules;	// rules of the ignore files read so far
+	std::deque<size_t> _queue;	// nodes waiting to be listed
+	std::map<DirectoryId, size_t> _walked;	// node walking each directory listed so far
+	size_t _busy;	// nodes being listed
+	std::mutex _lock;	// guards all of the above
+	std::condition_variable _ready;	// a node was queued, or a listing finished
+
+	// drop the files and subdirectories the rules ignore from listing
+	static void prune(const std::string& path, const IgnoreRules& rules, DirectoryWalker::Listing& listing) {
+		size_t kept = 0;
+		for (size_t i=0;i<listing.files.size();i++)
+			if (!rules.ignored(path + listing.files[i], false)) {
+				listing.files[kept].swap(listing.files[i]);
+				listing.matched[kept++] = listing.matched[i];
+			}
+		listing.files.resize(kept);
+		listing.matched.resize(kept);
+		kept = 0;
+		for (size_t i=0;i<listing.directories.size();i++)
+			if (!rules.ignored(path + listing.directories[i], true))
+				listing.directories[kept++].swap(listing.directories[i]);
+		listing.directories.resize(kept);
+	}
+
+	// whether node n walks its directory, listed and with device and inode set
+	// a directory reached more than once, through a link up the tree or elsewhere, is walked
+	// by the node depth first order meets first, whichever worker listed it first
+	bool claim(size_t n) {
+		if (isDropped(n)) return false;
+		if (_nodes[n].inode==0) return true;
+		std::map<DirectoryId, size_t>::iterator it = _walked.find(DirectoryId(_nodes[n].device, _nodes[n].inode));
+		if (it==_walked.end()) {
+			_walked[DirectoryId(_nodes[n].device, _nodes[n].inode)] = n;
+			return true;
+		}
+		Node& other = _nodes[it->second];
+		if (!isDropped(it->second) && precedes(it->second, n)) return false;
+		other.isDropped = true;	// its subdirectories, queued or listed, are left out with it
+		other.files.clear();
+		other.matched.clear();
+		other.children.clear();
+		it->second = n;
+		return true;
+	}
+
+	// whether node n or a directory above it is dropped
+	bool isDropped(size_t n) const {
+		for (;n!=none;n=_nodes[n].parent)
+			if (_nodes[n].isDropped) return true;
+		return false;
+	}
+
+	// whether node a comes before node b depth first, a directory before those below it
+	bool precedes(size_t a, size_t b) const {
+		std::vector<size_t> above, below;	// nodes from a and from b up to the root
+		for (;a!=none;a=_nodes[a].parent) above.push_back(a);
+		for (;b!=none;b=_nodes[b].parent) below.push_back(b);
+		size_t i = above.size(), j = below.size();
+		while (i>0 && j>0 && above[i-1]==below[j-1]) {
+			i--;
+			j--;
+		}
+		if (i==0) return true;	// a is b or above it
+		if (j==0) return false;
+		return _nodes[above[i-1]].index<_nodes[below[j-1]].index;
+	}
+};
+
+//----< files matching pattern under path >--------------------------------
+
+std::vector<std::string> DirectoryWalker::walk(std::string path, bool isRecursive, const std::string& pattern, size_t workers) {
+	return walk(path, isRecursive, std::vector<std::string>(1, pattern), workers);
+}
+
+//----< files matching any of patterns under path, in one walk >-----------
+
+std::vector<std::string> DirectoryWalker::walk(std::string path, bool isRecursive, const std::vector<std::string>& patterns,
+	size_t workers, const IgnoreRules* pRules) {
+	if (path.empty() || (path[path.length()-1]!='/' && path[path.length()-1]!='\\'))
+		path += "/";
+	PatternSet matcher(patterns);
+	TreeWalk tree(matcher, isRecursive);
+	tree.add(path, TreeWalk::none, pRules);
+	std::vector<std::thread> pool;
+	for (size_t i=1;isRecursive && i<workers;i++)
+		pool.push_back(std::thread(&TreeWalk::work, &tree));
+	tree.work();	// this thread is a worker too
+	for (auto & t : pool) t.join();
+	std::vector<std::string> files;
+	for (size_t i=0;i<patterns.size();i++)	// in pattern order, as one walk per pattern would list them
+		tree.collect(0, (int)i, files);
+	return files;
+}
+
+//----< files not ignored by the rules or the ignore files on their paths >--
+
+std::vector<std::string> DirectoryWalker::filter(const std::vector<std::string>& files, IgnoreRules rules) {
+	std::set<std::string> read;	// directories whose ignore file is read
+	std::vector<std::string> kept;
+	for (size_t i=0;i<files.size();i++) {
+		const std::string& file = files[i];
+		bool isIgnored = false;
+		bool isRelative = !file.empty() && file[0]!='/' && file[0]!='\\' && (file.length()<2 || file[1]!=':');
+		if (isRelative && !rules.ignoreFile().empty() && read.insert("").second)
+			rules.read(rules.ignoreFile(), "");	// the current directory
+		// directories on the path from the top, each read before the directories below it
+		for (size_t pos=file.find_first_of("/\\"); !isIgnored && pos!=std::string::npos; pos=file.find_first_of("/\\", pos+1)) {
+			std::string directory = file.substr(0, pos+1);
+			if (pos>0) isIgnored = rules.ignored(file.substr(0, pos), true);
+			if (!isIgnored && !rules.ignoreFile().empty() && read.insert(directory).second)
+				rules.read(directory+rules.ignoreFile(), directory);
+		}
+		if (!isIgnored && !rules.ignored(file, false))
+			kept.push_back(file);
+	}
+	return kept;
+}
+
+#ifdef _WIN32
+
+//----< list directory with FileSystem::Directory >------------------------
+
+bool DirectoryWalker::list(const std::string& directory, const PatternSet& patterns, Listing& listing, const std::string& ignoreFile) {
+	std::vector<std::string> files = FileSystem::Directory::getFiles(directory);
+	std::vector<std::string> directories = FileSystem::Directory::getDirectories(directory);
+	listing.files.clear();
+	listing.matched.clear();
+	listing.directories.clear();
+	listing.hasIgnoreFile = false;
+	listing.device = listing.inode = 0;
+	for (size_t i=0;i<files.size();i++) {
+		if (!ignoreFile.empty() && foldCase(files[i])==foldCase(ignoreFile))
+			listing.hasIgnoreFile = true;
+		int first = patterns.match(files[i].c_str());
+		if (first<0) continue;
+		listing.files.push_back(files[i]);
+		listing.matched.push_back(first);
+	}
+	for (size_t i=0;i<directories.size();i++)
+		if (directories[i]!="." && directories[i]!="..")
+			listing.directories.push_back(directories[i]);
+	return true;
+}
+
+#else
+
+//----< list directory reading it once >-----------------------------------
+
+bool DirectoryWalker::list(const std::string& directory, const PatternSet& patterns, Listing& listing, const std::string& ignoreFile) {
+	listing.files.clear();
+	listing.matched.clear();
+	listing.directories.clear();
+	listing.hasIgnoreFile = false;
+	listing.device = listing.inode = 0;
+	DIR* dir = opendir(directory.c_str());
+	if (!dir) return false;
+	struct stat st;
+	if (fstat(dirfd(dir), &st)==0) {	// the directory itself, through any link to it
+		listing.device = st.st_dev;
+		listing.inode = st.st_ino;
+	}
+	while (dirent* e = readdir(dir)) {
+		const char* name = e->d_name;
+		if (name[0]=='.' && (name[1]==0 || (name[1]=='.' && name[2]==0)))
+			continue;
+		bool isDirectory = e->d_type==DT_DIR;
+		if (e->d_type==DT_LNK || e->d_type==DT_UNKNOWN) {	// the type of a link is the type of its target
+			if (fstatat(dirfd(dir), name, &st, 0)!=0) continue;	// dangling link
+			isDirectory = S_ISDIR(st.st_mode);
+		}
+		int first;
+		if (!isDirectory && !ignoreFile.empty() && ignoreFile==name)
+			listing.hasIgnoreFile = true;
+		if (isDirectory)
+			listing.directories.push_back(name);
+		else if ((first = patterns.match(name))>=0) {
+			listing.files.push_back(name);
+			listing.matched.push_back(first);
+		}
+	}
+	closedir(dir);
+	return true;
+}
+
+#endif
+
+#ifdef TEST_DIRECTORYWALKER
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing DirectoryWalker\n ";
+	std::string path = (argc>1) ? argv[1] : "../";
+	std::string pattern = (argc>2) ? argv[2] : "*.h";
+	std::vector<std::string> serial = DirectoryWalker::walk(path, true, pattern);
+	std::vector<std::string> parallel = DirectoryWalker::walk(path, true, pattern, 8);
+	for (size_t i=0;i<serial.size();i++)
+		std::cout << "\n " << serial[i];
+	std::cout << "\n " << serial.size() << " files, the same with 8 threads: " << (serial==parallel);
+	std::cout << "\n " << DirectoryWalker::walk(path, false, pattern).size() << " of them directly under " << path;
+	std::vector<std::string> patterns;
+	patterns.push_back("*.h");
+	patterns.push_back("*.cpp");
+	patterns.push_back("*.h");	// listed once
+	patterns.push_back("Parser*");	// a glob, matches files the others did not
+	std::vector<std::string> all = DirectoryWalker::walk(path, true, patterns, 8);
+	std::cout << "\n " << all.size() << " files for *.h, *.cpp, *.h and Parser*";
+	PatternSet set(patterns);
+	std::cout << "\n first pattern of Parser.h, Parser.cpp, Parser.txt, a.c: "
+		<< set.match("Parser.h") << " " << set.match("Parser.cpp") << " " << set.match("Parser.txt") << " " << set.match("a.c");
+	IgnoreRules rules;
+	rules.add("Graph/", path);
+	rules.add("*Test*");
+	rules.add("!*Tests.h");
+	rules.ignoreFile(".gitignore");
+	std::vector<std::string> kept = DirectoryWalker::walk(path, true, patterns, 8, &rules);
+	std::cout << "\n " << kept.size() << " of them outside Graph/, without *Test* but with *Tests.h, and not in .gitignore files";
+	std::cout << "\n lib/a/b.h ignored by a/**/*.h: ";
+	rules.add("a/**/*.h", "lib");
+	std::cout << rules.ignored("lib/a/b.h", false) << rules.ignored("lib/a/x/y/b.h", false) << rules.ignored("lib/b.h", false);
+	std::vector<std::string> given;
+	given.push_back("lib/a/b.h");
+	given.push_back("lib/c.h");
+	given.push_back("lib/Graph/Graph.h");
+	std::cout << "\n of lib/a/b.h, lib/c.h and lib/Graph/Graph.h, filter() keeps " << DirectoryWalker::filter(given, rules).size() << ", not lib/a/b.h";
+	std::cout << "\n\n";
+}
+#endif
@@ -0,0 +1,188 @@
+#ifndef DIRECTORYWALKER_H
+#define DIRECTORYWALKER_H
+
+//////////////////////////////////////////////////////////////////////////
+//	DirectoryWalker.h - Lists the files of a directory tree, walking	//
+//	subdirectories in parallel											//
+//																		//
+//	ver 0.5																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+DirectoryWalker finds the files matching any of a list of patterns in a
+directory and, when recursive, in all its subdirectories.  The tree is
+walked once however many patterns there are.  The result is the same list,
+in the same order, as one depth first walk per pattern, one after another,
+except that a file is listed only once, for the first pattern it matches.
+A depth first walk lists the files of a directory, then the files under
+each of its subdirectories in listing order.  Every path is the directory
+path, ending with '/' unless it ends with a separator, followed by the name.
+
+A PatternSet matches a name against all patterns at once.  Patterns of the
+form "*.ext" are kept in a hash set of extensions, so the usual patterns
+cost one lookup per name; "*" and "*.*" match every name; only other
+patterns are tried one by one as globs.
+
+Directories are listed by a pool of worker threads taking them from one
+queue, so the listings of many directories are in flight at once, which
+is what matters on a network file system.  Each listing is kept in a node
+of the tree, and the result is put together from the nodes at the end.
+
+Given IgnoreRules, ignored files are dropped and ignored subdirectories are
+never listed.  The rules are the lines of .gitignore files: a rule without
+a slash matches the name of a file or directory at any depth, other rules
+match the path relative to the directory they were given for, "**" matches
+any number of directories, a trailing '/' matches directories only, and a
+leading '!' keeps what an earlier rule ignored.  The last matching rule
+decides.  When an ignore file name is set, e.g. ".gitignore", the file of
+that name in every walked directory adds its rules for the paths under it.
+filter() applies the rules to files which are given instead of walked: a
+file is dropped when it or a directory on its path, as spelled, is ignored,
+and the ignore file of every such directory is read, from the top down.
+
+A directory is walked once, by device and inode, however many links reach
+it.  It is walked where a depth first walk meets it first, whichever worker
+lists it first; so a link back up the tree is not followed, and of two links
+to the same tree only the first in listing order is.  Directories have no
+device and inode on Windows, so there is no such check there.
+
+On Windows a directory is listed with FileSystem::Directory, and names are
+matched ignoring case, as FindFirstFile does.  Elsewhere it is read once
+with opendir/readdir: the entry type given by readdir tells files from
+subdirectories, and only links and entries of unknown type are looked up
+with fstatat.  Glob patterns are matched with fnmatch there.
+
+Public Interface:
+=================
+std::vector<std::string> files = DirectoryWalker::walk(path, isRecursive, "*.h");
+std::vector<std::string> files = DirectoryWalker::walk(path, isRecursive, patterns, numberOfWorkers);
+IgnoreRules rules;
+rules.add("build/", path);	// a rule for the paths under path
+rules.add("*.generated.cpp");	// a rule for every path
+rules.ignoreFile(".gitignore");
+std::vector<std::string> files = DirectoryWalker::walk(path, isRecursive, patterns, numberOfWorkers, &rules);
+std::vector<std::string> kept = DirectoryWalker::filter(givenFiles, rules);
+PatternSet patterns(arrayOfPattern);
+int first = patterns.match("Parser.cpp");	// index of the first matching pattern, -1 for none
+DirectoryWalker::Listing listing;
+bool res = DirectoryWalker::list("../lib/", patterns, listing);
+
+Maintanence Information:
+========================
+Required files:
+---------------
+DirectoryWalker.h, DirectoryWalker.cpp, FileSystem.h, FileSystem.cpp (Windows)
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.5 a directory reached twice through links is walked once
+- ver 0.4 added filter()
+- ver 0.3 added IgnoreRules, links back up the tree are not walked
+- ver 0.2 added PatternSet, walk() takes all patterns at once
+- ver 0.1 first version
+
+*/
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+///////////////////////////////////////////////////////////////
+// PatternSet class, matches names against a list of patterns
+class PatternSet {
+public:
+	explicit PatternSet(const std::vector<std::string>& patterns);
+
+	// index of the first pattern matching name, -1 if none matches
+	int match(const char* name) const;
+
+	size_t size() const { return _patterns.size(); }
+
+	// whether name matches the glob pattern
+	static bool glob(const std::string& pattern, const char* name);
+
+private:
+	std::vector<std::string> _patterns;
+	std::unordered_map<std::string, int> _extensions;	// "cpp" -> first "*.cpp" pattern
+	std::vector<int> _globs;	// other patterns, in order
+	int _all;	// first pattern matching every name, -1 if none
+};
+
+///////////////////////////////////////////////////////////////
+// IgnoreRules class, .gitignore style rules for paths to skip
+class IgnoreRules {
+public:
+	// add a rule for the paths under directory, or for every path
+	void add(const std::string& rule, const std::string& directory="");
+
+	// add the rules of an ignore file for the paths under directory, false if it cannot be read
+	bool read(const std::string& file, const std::string& directory);
+
+	// name of the ignore file read in every walked directory, empty for none
+	void ignoreFile(const std::string& name) { _ignoreFile = name; }
+	const std::string& ignoreFile() const { return _ignoreFile; }
+
+	// whether the file or directory at path, as the walk spells it, is ignored
+	bool ignored(const std::string& path, bool isDirectory) const;
+
+	bool empty() const { return _rules.empty(); }
+
+private:
+	///////////////////////////////////////////////////////////////
+	// one rule
+	struct Rule {
+		std::string directory;	// the rule is for paths starting with it
+		size_t depth;	// number of names in directory
+		std::vector<std::string> names;	// of the pattern, split at '/'
+		bool isAnchored;	// matches the path below directory, not just the last name
+		bool isNegated;	// a match keeps the path
+		bool isDirectoryOnly;	// matches directories only
+	};
+
+	std::vector<Rule> _rules;
+	std::string _ignoreFile;
+
+	// whether path[s..] matches names[n..]
+	static bool match(const std::vector<std::string>& names, size_t n, const std::vector<std::string>& path, size_t s);
+};
+
+///////////////////////////////////////////////////////////////
+// DirectoryWalker class
+class DirectoryWalker {
+public:
+	///////////////////////////////////////////////////////////////
+	// names found in one directory, in listing order
+	struct Listing {
+		std::vector<std::string> files;	// matching a pattern
+		std::vector<int> matched;	// first pattern matched by each file
+		std::vector<std::string> directories;	// without "." and ".."
+		bool hasIgnoreFile;	// the ignore file asked for is in the directory
+		unsigned long long device, inode;	// of the directory, 0 where unknown
+	};
+
+	// files matching pattern under path, listed by that many threads
+	static std::vector<std::string> walk(std::string path, bool isRecursive, const std::string& pattern, size_t workers=1);
+
+	// files matching any of patterns under path, each listed once, skipping what pRules ignores
+	static std::vector<std::string> walk(std::string path, bool isRecursive, const std::vector<std::string>& patterns,
+		size_t workers=1, const IgnoreRules* pRules=0);
+
+	// the files which neither the rules nor the ignore files on their paths ignore
+	static std::vector<std::string> filter(const std::vector<std::string>& files, IgnoreRules rules);
+
+	// list the directory, looking for ignoreFile too, return whether it could be read
+	static bool list(const std::string& directory, const PatternSet& patterns, Listing& listing, const std::string& ignoreFile="");
+};
+
+#endif
@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////////////
+//	DirectoryWatcher.cpp - Reports files created, changed or deleted	//
+//	in watched directories												//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Package Operations:
+===================
+Implements DirectoryWatcher, and tests it
+
+Public Interface:
+=================
+none
+
+Maintanence Information:
+========================
+Required files:
+---------------
+DirectoryWatcher.h
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.1 : initial version.
+
+*/
+#include "DirectoryWatcher.h"
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+#ifdef __linux__
+
+// the events a watched directory reports
+static const unsigned int watchedEvents =
+	IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF;
+
+//----< constructor, open an inotify instance >----------------------------
+
+DirectoryWatcher::DirectoryWatcher() : _fd(inotify_init1(IN_CLOEXEC)) {}
+
+//----< destructor, close the instance and all its watches >---------------
+
+DirectoryWatcher::~DirectoryWatcher() {
+	if (_fd >= 0) close(_fd);
+}
+
+bool DirectoryWatcher::isSupported() { return true; }
+
+//----< watch one directory >----------------------------------------------
+
+bool DirectoryWatcher::add(std::string directory) {
+	if (_fd < 0 || directory.empty()) return false;
+	if (directory[directory.length()-1]!='/' && directory[directory.length()-1]!='\\')
+		directory += "/";
+	int wd = inotify_add_watch(_fd, directory.c_str(), watchedEvents);
+	if (wd < 0) return false;
+	_directories[wd] = directory;
+	return true;
+}
+
+//----< wait for a batch of changes >--------------------------------------
+
+bool DirectoryWatcher::wait(std::vector<Change>& changes, int settleMs) {
+	changes.clear();
+	if (_fd < 0) return false;
+	pollfd p = { _fd, POLLIN, 0 };
+	for (int timeout=-1;;timeout=settleMs) {	// block for the first event only
+		int n = poll(&p, 1, timeout);
+		if (n < 0 && errno == EINTR) continue;
+		if (n < 0) return false;
+		if (n == 0) return true;	// settled
+		if (!read(changes)) return false;
+	}
+}
+
+//----< translate the pending events >-------------------------------------
+
+bool DirectoryWatcher::read(std::vector<Change>& changes) {
+	// aligned for inotify_event, large enough for many events
+	union { inotify_event event; char bytes[64 * 1024]; } buffer;
+	ssize_t length = ::read(_fd, buffer.bytes, sizeof(buffer.bytes));
+	if (length < 0) return errno == EINTR || errno == EAGAIN;
+	for (char* p = buffer.bytes; p < buffer.bytes + length; ) {
+		const inotify_event* e = (const inotify_event*)p;
+		p += sizeof(inotify_event) + e->len;
+		if (e->mask & IN_Q_OVERFLOW) {	// the queue was full, wd is -1
+			Change c;
+			c.kind = Overflow;
+			changes.push_back(c);
+			continue;
+		}
+		std::unordered_map<int, std::string>::iterator it = _directories.find(e->wd);
+		if (it == _directories.end()) continue;
+		if (e->mask & (IN_IGNORED | IN_DELETE_SELF)) {	// the directory itself is gone
+			if (e->mask & IN_IGNORED) _directories.erase(it);
+			continue;
+		}
+		if (e->len == 0) continue;
+		Change c;
+		c.directory = it->second;
+		c.name = e->name;
+		bool isDir = (e->mask & IN_ISDIR) != 0;
+		if (e->mask & (IN_CREATE | IN_MOVED_TO))
+			c.kind = isDir ? DirectoryCreated : Created;
+		else if (e->mask & (IN_DELETE | IN_MOVED_FROM))
+			c.kind = isDir ? DirectoryDeleted : Deleted;
+		else if (e->mask & IN_CLOSE_WRITE)
+			c.kind = Modified;
+		else
+			continue;
+		changes.push_back(c);
+	}
+	return true;
+}
+
+#else
+
+// no watching on this platform
+
+DirectoryWatcher::DirectoryWatcher() : _fd(-1) {}
+DirectoryWatcher::~DirectoryWatcher() {}
+bool DirectoryWatcher::isSupported() { return false; }
+bool DirectoryWatcher::add(std::string) { return false; }
+bool DirectoryWatcher::wait(std::vector<Change>& changes, int) { changes.clear(); return false; }
+bool DirectoryWatcher::read(std::vector<Change>&) { return false; }
+
+#endif
+
+#ifdef TEST_DIRECTORYWATCHER
+
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing DirectoryWatcher\n ";
+	if (!DirectoryWatcher::isSupported()) {
+		std::cout << "\n  not supported on this platform\n\n";
+		return 0;
+	}
+	DirectoryWatcher watcher;
+	std::string dir = (argc>1) ? argv[1] : ".";
+	std::cout << "\n watching " << dir << ": " << watcher.add(dir);
+	const char* kinds[] = { "modified", "created", "deleted", "directory created", "directory deleted", "changes lost" };
+	std::vector<DirectoryWatcher::Change> changes;
+	for (int batch=0;batch<3 && watcher.wait(changes);batch++) {
+		std::cout << "\n batch " << batch;
+		for (size_t i=0;i<changes.size();i++)
+			std::cout << "\n  " << kinds[changes[i].kind] << " " << changes[i].path();
+	}
+	std::cout << "\n\n";
+}
+#endif
@@ -0,0 +1,116 @@
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+//////////////////////////////////////////////////////////////////////////
+//	DirectoryWatcher.h - Reports files created, changed or deleted in	//
+//	watched directories													//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A DirectoryWatcher is told about changes in the directories added to it, so
+a long running analysis parses only the files which changed instead of
+walking the whole tree again.  A directory is watched by itself; to watch a
+tree, add every directory of it, and add new ones as they are reported.
+
+wait() blocks until something changes, then keeps collecting changes until
+none has come for settleMs milliseconds, so a save that writes a temporary
+file and renames it is reported at once.  A file may be reported more than
+once in one batch.  The directory of a change is the string it was added
+with, followed by '/' if it did not end with a separator.  When more
+changes come than the system can queue, some are lost; this is reported as
+an Overflow change, after which anything watched may have changed and the
+tree should be walked again.
+
+Changes are read from inotify on Linux.  Elsewhere isSupported() is false
+and nothing can be watched.
+
+Public Interface:
+=================
+if (DirectoryWatcher::isSupported()) {
+	DirectoryWatcher watcher;
+	watcher.add("../lib/");
+	std::vector<DirectoryWatcher::Change> changes;
+	while (watcher.wait(changes))
+		for (auto & c : changes)
+			std::cout << c.kind << " " << c.path();
+}
+
+Maintanence Information:
+========================
+Required files:
+---------------
+DirectoryWatcher.h, DirectoryWatcher.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.1 first version
+
+*/
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+///////////////////////////////////////////////////////////////
+// DirectoryWatcher class
+class DirectoryWatcher {
+public:
+	enum ChangeKind {
+		Modified,	// file written and closed
+		Created,	// file created or moved in
+		Deleted,	// file deleted or moved out
+		DirectoryCreated,	// subdirectory created or moved in, not watched yet
+		DirectoryDeleted,	// subdirectory deleted or moved out
+		Overflow	// changes were lost, directory and name are empty
+	};
+
+	///////////////////////////////////////////////////////////////
+	// one reported change
+	struct Change {
+		ChangeKind kind;
+		std::string directory;	// as added, ending with a separator
+		std::string name;	// of the file or subdirectory
+		std::string path() const { return directory + name; }
+	};
+
+	DirectoryWatcher();
+	~DirectoryWatcher();
+
+	// whether directories can be watched on this platform
+	static bool isSupported();
+
+	// watch one directory, not its subdirectories, return whether it succeeds
+	bool add(std::string directory);
+
+	// wait for changes, then collect them until none comes for settleMs, false on error
+	bool wait(std::vector<Change>& changes, int settleMs=20);
+
+	// number of directories watched
+	size_t size() const { return _directories.size(); }
+
+private:
+	int _fd;	// inotify instance, -1 if there is none
+	std::unordered_map<int, std::string> _directories;	// watch descriptor -> directory
+
+	// read the pending events into changes, return whether it succeeds
+	bool read(std::vector<Change>& changes);
+
+	// prohibit copies and assignments
+	DirectoryWatcher(const DirectoryWatcher&);
+	DirectoryWatcher& operator=(const DirectoryWatcher&);
+};
+
+#endif
@@ -47,7 +47,8 @@ int main()
 	patterns.push_back("*.h");
 	patterns.push_back("*.cpp");
 	std::vector<std::string> files = FileManager::getFileList("../", true, patterns);
-	if (FileManager::parse(files)) {
+	SymbolDatabase db;
+	if (FileManager::parse(files, &db)) {
 		std::cout << "\n All file parsed! \n";
 	}
 	FileManager::save("./test.txt", "SAVE SUCCEED!");
@@ -20,22 +20,84 @@ It includes a couple of static functions which will read/write file, also,
 the parse function will directly initialize the ConfigureParser instance and
 parse the files with it.
 
+A list of files is parsed with parsers taken from a ParserPool, so the
+Toker/SemiExp/Parser pipeline with its rules and actions is built once and
+attached to one file after another, instead of being rebuilt per file.
+
+When more than one worker is requested, the files are grouped by package
+(a.h and a.cpp share one SymbolTable) and the groups are handed out to a
+pool of threads.  Each worker takes one parser from the pool for all the
+files it parses, and files of one package are always parsed by one worker
+in list order, so every SymbolTable is filled exactly as it would be by
+the serial run.
+
+Given an AnalysisCache, a file whose content is unchanged since it was
+cached is not parsed: its facts are replayed into its SymbolTable.  Other
+files are parsed while their table records what they add, and the facts
+are stored in the cache for the next run.  A file already checked against
+the cache in this run is replayed without reading it again.
+
+getFileList() walks the directory tree once with DirectoryWalker, matching
+every file against all the patterns; a file matching several is listed once.
+Given more than one worker, subdirectories are listed by that many threads
+and the list comes out in the same order as a serial walk.  Given
+IgnoreRules, ignored files are left out and ignored directories are pruned
+from the walk.
+
+readFileList() takes the list of files from a list file or a stream
+instead, so a build which knows its sources skips the walk.  The paths
+are separated by NULs when there are any in the list, by line ends
+otherwise; empty entries and repeated paths are dropped.
+
 Public Interface:
 =================
-FileManager::parse(arrayOfFile);
-FileManager::parse(filePath);
+FileManager::parse(arrayOfFile, pDatabase);
+FileManager::parse(arrayOfFile, pDatabase, numberOfWorkers);
+FileManager::parse(arrayOfFile, pDatabase, numberOfWorkers, pCache);
+FileManager::parse(filePath, pDatabase);
+FileManager::parse(filePath, pConfig);	// with a built parser, see ParserPool
+FileManager::parse(filePath, pConfig, pCache);
 string content = FileManager::read(filePath);
 FileManager::save(filePath, content);
 FileManager::getFileList(path, isRecursive, searchPattern);
+FileManager::getFileList(path, isRecursive, searchPattern, numberOfWorkers);
+FileManager::getFileList(path, isRecursive, arrayOfSearchPattern, numberOfWorkers);
+FileManager::getFileList(path, isRecursive, arrayOfSearchPattern, numberOfWorkers, pIgnoreRules);
+bool res = FileManager::readFileList(listFile, arrayOfFile);
+bool res = FileManager::readFileList(std::cin, arrayOfFile);
 
 Maintanence Information:
 ========================
 Required files:
 ---------------
-- ConfigureParser.h, ConfigureParser.cpp, Parser.h, Parser.cpp, FileSystem.h, FileSystem.cpp
+- ConfigureParser.h, ConfigureParser.cpp, Parser.h, Parser.cpp,
+  SymbolDatabase.h, SymbolDatabase.cpp, MappedFile.h, MappedFile.cpp,
+  AnalysisCache.h, AnalysisCache.cpp, DirectoryWalker.h, DirectoryWalker.cpp,
+  FileSystem.h, FileSystem.cpp on Windows, for DirectoryWalker
 
 Maintenance History:
 ====================
+ver 1.1 : 17 Oct 26
+- parseParallel() hands every package to the workers, ioLock() is created before they start
+ver 1.0 : 17 Oct 26
+- added readFileList(), the list of files from a list file or a stream
+ver 0.9 : 17 Oct 26
+- getFileList() takes IgnoreRules for files and directories to skip
+ver 0.8 : 17 Oct 26
+- getFileList(path, isRecursive, patterns) walks the tree once, listing each file once
+ver 0.7 : 17 Oct 26
+- file lists are found by DirectoryWalker, getFileList(path, isRecursive, pattern, workers)
+ver 0.6 : 17 Oct 26
+- files checked in the cache before in this run are replayed without stamping
+ver 0.5 : 17 Oct 26
+- files unchanged since they were cached in an AnalysisCache are not parsed
+ver 0.4 : 17 Oct 26
+- files are parsed by reused parsers from a ParserPool
+ver 0.3 : 17 Oct 26
+- read() copies the file from a memory mapping
+ver 0.2 : 17 Oct 26
+- added multi-threaded parsing, parse(files, pDatabase, workers)
+- symbol tables are collected in the SymbolDatabase given by caller
 ver 0.1 : 01 Jun 11
 - first version
 
@@ -44,9 +106,19 @@ ver 0.1 : 01 Jun 11
 #include <sstream>
 #include <string>
 #include <algorithm>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <iterator>
+#include <thread>
+#include <mutex>
+#include <atomic>
 #include "Parser.h"
 #include "ConfigureParser.h"
-#include "FileSystem.h"
+#include "SymbolDatabase.h"
+#include "MappedFile.h"
+#include "AnalysisCache.h"
+#include "DirectoryWalker.h"
 
 ///////////////////////////////////////////////////////////////
 // FileManager class
@@ -55,44 +127,87 @@ public:
 
 	///////////////////////////////////////////////////////////////
 	// parse all files listed in the vector, return whether the parsing succeed
+	// when workers>1, files are parsed by a pool of that many threads
+	// when pCache is given, unchanged files are taken from it, others are stored in it
 
-	static bool parse(std::vector<std::string>& files) {
+	static bool parse(std::vector<std::string>& files, SymbolDatabase* pDb, size_t workers=1, AnalysisCache* pCache=0) {
 		bool res=true;
 		if (files.size()<1) {
 			std::cout<<"\n No file is found under the specific directory!!";
 			return false;
 		}
+		ParserPool parsers(pDb);
+		if (workers>1)
+			return parseParallel(files, parsers, workers, pCache);
 		// start parsing file
+		ConfigParseToConsole* pConfig = parsers.acquire();
 		for (size_t i=0;res && i<files.size();i++)
-			res = parse(files[i]);
+			res = parse(files[i], pConfig, pCache);
+		parsers.release(pConfig);
 		return res;
 	}
 
 	///////////////////////////////////////////////////////////////
 	// parse file use parser
 
-	static bool parse(const std::string& path) {
-		std::cout << "\n  Processing file " << path;
-		ConfigParseToConsole configure;
-		Parser* pParser = configure.Build();
+	static bool parse(const std::string& path, SymbolDatabase* pDb) {
+		ParserPool parsers(pDb);
+		return parse(path, parsers.acquire());
+	}
+
+	///////////////////////////////////////////////////////////////
+	// parse file with a built parser, 0 if it could not be built
+	// when pCache is given, the file is taken from it if unchanged, else stored in it
+
+	static bool parse(const std::string& path, ConfigParseToConsole* pConfig, AnalysisCache* pCache=0) {
+		AnalysisCache::Stamp stamp;
+		FileFacts facts;
+		if (pConfig && pCache && pCache->checked(path, facts)) {
+			pConfig->database()->create(path)->replay(facts);
+			return true;
+		}
+		if (pCache && !AnalysisCache::stampOf(path, stamp))
+			pCache = 0;	// cannot be read, Attach() reports it
+		if (pConfig && pCache && pCache->find(path, stamp, facts)) {
+			{
+				std::lock_guard<std::mutex> lock(ioLock());
+				std::cout << "\n  Processing file " << path << " (cached)";
+			}
+			pConfig->database()->create(path)->replay(facts);
+			return true;
+		}
+		{
+			std::lock_guard<std::mutex> lock(ioLock());
+			std::cout << "\n  Processing file " << path;
+		}
+		Parser* pParser = pConfig ? pConfig->parser() : 0;
 		try {
 			if(pParser) {
-				if(!configure.Attach(path)) {
+				if(!pConfig->Attach(path)) {
+					std::lock_guard<std::mutex> lock(ioLock());
 					std::cout << "\n  could not open file " << path << std::endl;
 					return false;
 				}
 			}
 			else {
+				std::lock_guard<std::mutex> lock(ioLock());
 				std::cout << "\n\n  Parser not built\n\n";
 				return false;
 			}
+			if (pCache) pConfig->symbols()->record(&facts);
 			// now that parser is built, use it
 			while(pParser->next()) pParser->parse();
 		}
 		catch(std::exception& ex) {
+			if (pCache) pConfig->symbols()->record(0);
+			std::lock_guard<std::mutex> lock(ioLock());
 			std::cout << "\n\n    " << ex.what() << "\n\n";
 			return false;
 		}
+		if (pCache) {
+			pConfig->symbols()->record(0);
+			pCache->store(path, stamp, facts);
+		}
 		return true;
 	}
 
@@ -114,47 +229,128 @@ public:
 	// get string from a file
 
 	static std::string read(const std::string& inpath) {
-		std::ifstream inf(inpath);
-		//std::string str;
-		std::ostringstream ss;
-		if (inf.good()) ss << inf.rdbuf() << std::endl;
-		inf.close();
-		return ss.str();
+		MappedFile inf;
+		if (!inf.open(inpath)) return "";
+		std::string str;
+		str.reserve(inf.size()+1);
+		str.append(inf.data(), inf.size()).append(1, '\n');
+		return str;
 	}
 
 	///////////////////////////////////////////////////////////////
 	// get a list of file path under specific path
+	// what pRules ignores is skipped, ignored directories are not listed at all
 
-	static std::vector<std::string> getFileList(std::string path, bool isRecursive, std::vector<std::string> patterns) {
-		std::vector<std::string> files;
-		std::for_each(patterns.begin(), patterns.end(), [&path, &isRecursive, &files] (const std::string &pattern) {
-			std::vector<std::string> _files = getFileList(path, isRecursive, pattern);
-			files.insert(files.end(), _files.begin(), _files.end());
-		});
-		return files;
+	static std::vector<std::string> getFileList(std::string path, bool isRecursive, std::vector<std::string> patterns,
+		size_t workers=1, const IgnoreRules* pRules=0) {
+		return DirectoryWalker::walk(path, isRecursive, patterns, workers, pRules);	// one walk for all patterns
 	}
 
 	///////////////////////////////////////////////////////////////
 	// get a list of file path under one specific directory
+	// when workers>1, subdirectories are listed by that many threads
 
-	static std::vector<std::string> getFileList(std::string path, bool isRecursive, std::string pattern) {
-		if (path[path.length()-1]!='/' && path[path.length()-1]!='\\')
-			path += "/";
-		std::vector<std::string> files = FileSystem::Directory::getFiles(path, pattern);
-		for (size_t i=0;i<files.size();i++) files[i]=path+files[i];
-		if (isRecursive) {
-			// get files from sub-directories
-			std::vector<std::string> subDirectories = FileSystem::Directory::getDirectories(path);
-			for (size_t i=0;i<subDirectories.size();i++) {
-				if (subDirectories[i]=="." || subDirectories[i]=="..")
-					continue;
-				else {
-					std::vector<std::string> _files = getFileList(path+subDirectories[i], isRecursive, pattern);
-					files.insert(files.end(), _files.begin(), _files.end());	// copy the files from sub-directories to current file list
-				}
+	static std::vector<std::string> getFileList(std::string path, bool isRecursive, std::string pattern, size_t workers=1) {
+		return DirectoryWalker::walk(path, isRecursive, pattern, workers);
+	}
+
+	///////////////////////////////////////////////////////////////
+	// read a list of file path from a list file, return whether it could be read
+
+	static bool readFileList(const std::string& listFile, std::vector<std::string>& files) {
+		MappedFile inf;
+		if (!inf.open(listFile)) return false;
+		splitFileList(inf.data(), inf.size(), files);
+		return true;
+	}
+
+	///////////////////////////////////////////////////////////////
+	// read a list of file path from a stream, e.g. std::cin, return whether it could be read
+
+	static bool readFileList(std::istream& in, std::vector<std::string>& files) {
+		std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		if (in.bad()) return false;
+		splitFileList(text.data(), text.size(), files);
+		return true;
+	}
+
+private:
+	typedef std::vector<size_t> fileGroup;	// indices of files sharing one package
+
+	///////////////////////////////////////////////////////////////
+	// split a list of file path at NULs if there are any, else at line ends
+	// empty entries and repeated files are dropped
+
+	static void splitFileList(const char* text, size_t size, std::vector<std::string>& files) {
+		files.clear();
+		const char* end = text + size;
+		char separator = (std::find(text, end, '\0')!=end) ? '\0' : '\n';
+		std::unordered_set<std::string> listed;
+		for (const char* begin = text; begin < end; ) {
+			const char* next = std::find(begin, end, separator);
+			const char* last = next;
+			if (separator=='\n' && last>begin && last[-1]=='\r') last--;
+			if (last>begin) {
+				std::string file(begin, last);
+				if (listed.insert(file).second) files.push_back(file);
+			}
+			begin = next + (next<end ? 1 : 0);
+		}
+	}
+
+	///////////////////////////////////////////////////////////////
+	// serialize console output of the parsing threads
+
+	static std::mutex& ioLock() {
+		static std::mutex lock;
+		return lock;
+	}
+
+	///////////////////////////////////////////////////////////////
+	// group files by package, register their SymbolTables in list order
+
+	static std::vector<fileGroup> groupByPackage(const std::vector<std::string>& files, SymbolDatabase* pDb) {
+		std::vector<fileGroup> groups;
+		std::unordered_map<std::string, size_t> groupIndex;	// package name -> index in groups
+		for (size_t i=0;i<files.size();i++) {
+			std::string package = SymbolTable::getPackageName(files[i]);
+			auto it = groupIndex.find(package);
+			if (it==groupIndex.end()) {
+				// creating the tables here keeps the registry identical to a serial run
+				pDb->create(files[i]);
+				groupIndex[package] = groups.size();
+				groups.push_back(fileGroup(1, i));
 			}
+			else
+				groups[it->second].push_back(i);
 		}
-		return files;
+		return groups;
+	}
+
+	///////////////////////////////////////////////////////////////
+	// parse files with a pool of worker threads
+
+	static bool parseParallel(std::vector<std::string>& files, ParserPool& parsers, size_t workers, AnalysisCache* pCache) {
+		std::vector<fileGroup> groups = groupByPackage(files, parsers.database());
+		// VC++ 2012 does not initialize function-level statics thread-safely, so the only
+		// one the workers share is created here; the parser's other statics are at
+		// namespace scope and constant tables, initialized before main()
+		ioLock();
+		std::atomic<size_t> next(0);
+		std::atomic<bool> ok(true);
+		auto worker = [&files, &groups, &next, &ok, &parsers, pCache] () {
+			ConfigParseToConsole* pConfig = parsers.acquire();
+			for (size_t g=next++; ok && g<groups.size(); g=next++) {
+				for (size_t i=0;ok && i<groups[g].size();i++)
+					if (!parse(files[groups[g][i]], pConfig, pCache)) ok=false;
+			}
+			parsers.release(pConfig);
+		};
+		if (workers>groups.size()) workers=groups.size();
+		std::vector<std::thread> pool;
+		for (size_t i=0;i<workers;i++) pool.push_back(std::thread(worker));
+		for (auto & t : pool) t.join();
+		return ok;
 	}
 };
 
@@ -23,7 +23,7 @@ Public Interface:
 SCCSorter sorter(pGraph);
 sorter.sort();
 sorter.show();
-sorter(vertex);
+std::vector<std::string> sequence = sorter.values();
 
 std::vector<Vertex<std::string, std::string>> vList = Display<std::string, std::string>::vertsWithNoParents(graph);
 Display<std::string, std::string>::show(graph);
@@ -35,6 +35,11 @@ Required files
 
 Maintenance History:
 ====================
+ver 0.3 : 17 Oct 26
+- added SCCSorter::values, the sorted sequence without showing it
+ver 0.2 : 17 Oct 26
+- SCCSorter sorts a CSRGraph instead of running dfs on the graph,
+  strong components with a cycle but no parent are no longer left out
 ver 0.1 : 19 Mar 13
 - first version
 
@@ -58,10 +63,20 @@ namespace GraphLib {
 		// do topological sort
 		void sort() {
 			if (pGraph->size()<1) return;
-			// just dfs the d_Graph
-			pGraph->dfs<SCCSorter>(*this);
-			// reverse sortedList
-			std::reverse(sortedList->begin(), sortedList->end());
+			// order the read-only copy of the d_Graph, sequential scans only
+			CSRGraph<V,E> csr(*pGraph);
+			std::vector<size_t> order = csr.topologicalOrder();
+			sortedList->clear();
+			for (size_t vIndex : order)
+				sortedList->push_back(csr.id(vIndex));
+		}
+
+		// return values of the current sorted sequence
+		std::vector<V> values() {
+			std::vector<V> vals;
+			for (auto it=sortedList->begin();it!=sortedList->end();it++)
+				vals.push_back((*pGraph)[pGraph->findVertexIndexById(*it)].value());
+			return vals;
 		}
 
 		// show current sorted sequence
@@ -70,11 +85,6 @@ namespace GraphLib {
 			for (auto it=sortedList->begin();it!=sortedList->end();it++)
 				std::cout<<"\n "<<(*pGraph)[pGraph->findVertexIndexById(*it)].value();
 		}
-
-		// a simple functor that push strong component index into list
-		void operator() (Vertex<V,E> & v) {
-			sortedList->push_back(v.id());
-		}
 	};
 
 	///////////////////////////////////////////////////////////////
@@ -102,7 +112,7 @@ namespace GraphLib {
 			iter = g.begin();
 			while(iter != g.end())
 			{
-				vertex v = *iter;
+				vertex& v = *iter;	// no copy of edges and value
 				for(size_t i=0; i<v.size(); ++i)
 				{
 					edge e = v[i];
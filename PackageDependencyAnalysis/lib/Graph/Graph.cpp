@@ -70,6 +70,7 @@ int main()
 		std::cout << "\n -------------------------";
 		for(auto& v : gcopy)
 			v.value() += "copy";
+		gcopy.rebuildValueIndex();
 
 		display::show(gcopy);
 		std::cout << "\n";
@@ -107,6 +108,24 @@ int main()
 		g.dfs(g[0], showFunctor());
 		std::cout << "\n";
 
+		std::cout << "\n  Testing bulk edge insertion";
+		std::cout << "\n -----------------------------";
+		graph gbulk = g;
+		EdgeBuilder<std::string, std::string> builder(gbulk);
+		builder.add("e1", 1, 0);	// already in graph
+		builder.add("e6", 3, 4);
+		builder.add("e6", 3, 4);	// duplicate
+		builder.add("e7", 3, 4);
+		builder.finalize();
+		const Adjacency& a = builder.adjacency();
+		for(size_t i=0; i<a.size(); ++i)
+		{
+			std::cout << "\n  vertex " << gbulk[i].id() << " children:";
+			for(size_t k=a.begin(i); k<a.end(i); ++k)
+				std::cout << " " << gbulk[a[k]].id();
+		}
+		std::cout << "\n";
+
 		std::cout << "\n  Testing Serialization to XML";
 		std::cout << "\n ------------------------------";
 		std::string str = GraphToXmlString(g);
@@ -121,6 +140,22 @@ int main()
 		display::show(gtest);
 		std::cout << "\n\n";
 
+		std::cout << "\n  Testing compressed sparse row graph";
+		std::cout << "\n -------------------------------------";
+		CSRGraph<std::string, std::string> csr(gbulk);
+		std::vector<size_t> degree = csr.inDegrees();
+		std::vector<bool> reached = csr.reachableFrom(0);
+		for(size_t i=0; i<csr.size(); ++i)
+		{
+			std::cout << "\n  vertex " << csr.value(i) << ", in-degree " << degree[i];
+			std::cout << (reached[i] ? ", reached from " : ", not reached from ") << csr.value(0);
+		}
+		std::cout << "\n  topological order:";
+		std::vector<size_t> order = csr.topologicalOrder();
+		for(size_t vIndex : order)
+			std::cout << " " << csr.value(vIndex);
+		std::cout << "\n";
+
 		std::cout << "\n  Testing strong components searching";
 		std::cout << "\n -------------------------------------";
 		GraphLib::SCCSearcher<std::string, std::string> searcher(&g);
@@ -46,6 +46,22 @@ size_t size = g.size();
 g.dfs<someFunctor>(v, someFunctorInstance);
 g.dfs<someFunctor>(someFunctorInstance);
 size_t i = g.addOrFindVertexByVal("some value");
+g.reserve(numberOfVertices);	// before adding many vertices
+g.rebuildValueIndex();	// after changing vertex values through value()
+g[i].clear();	// remove the edges of a vertex
+std::vector<size_t> newIndex = g.removeVertices(isRemoved);	// also the edges to them
+EdgeBuilder<std::string, std::string> builder(g);	// many edges at once
+builder.add("edge value", parentIndex, childIndex);	// unchecked append
+builder.finalize();	// drop duplicates, add edges to g
+const Adjacency& a = builder.adjacency();	// child indices of every vertex
+for(size_t k=a.begin(i); k<a.end(i); ++k) a[k];
+CSRGraph<std::string, std::string> csr(g);	// read-only copy for analysis
+std::string val = csr.value(i);
+std::vector<size_t> degree = csr.inDegrees();
+std::vector<bool> reached = csr.reachableFrom(i);
+csr.strongComponents(components, componentOf);
+csr.strongComponents(components, componentOf, &within);	// of the vertices within only
+std::vector<size_t> order = csr.topologicalOrder();
 v = g[0];	// get vertex by index
 Vertex<std::string, std::string>::Edge e = v[0];	// get edge
 std::string val = v.value();
@@ -54,6 +70,8 @@ std::string xml = GraphToXmlString<std::string, std::string>(g);
 
 SCCSearcher<std::string, std::string> searcher(&g);
 searcher.search();
+searcher.update(changedVertices, newIndex);	// after edges of changedVertices changed
+const std::vector<std::vector<size_t> >& components = searcher.Components();
 
 Maintanence Information:
 ========================
@@ -70,6 +88,24 @@ devenv Graph.sln /rebuild debug
 
 Revision History:
 -----------------
+ver 2.1 : 17 Oct 26
+- added Vertex::clear and Graph::removeVertices, strongComponents can
+  search part of a graph, SCCSearcher::update searches again only the
+  components a change can reach
+ver 2.0 : 17 Oct 26
+- added CSRGraph, an immutable compressed sparse row copy of a graph
+  with strong components, topological order, in-degrees and
+  reachability; SCCSearcher now runs on it
+ver 1.9 : 17 Oct 26
+- SCCSearcher runs Tarjan's algorithm with an explicit stack and
+  per-vertex arrays, no recursion
+ver 1.8 : 17 Oct 26
+- added EdgeBuilder, adds many edges without a duplicate check per edge,
+  duplicates are removed once by sorting, and Adjacency, a read-only
+  compact copy of the edges
+ver 1.7 : 17 Oct 26
+- addOrFindVertexByVal looks up a value index maintained by addVertex,
+  added reserve and rebuildValueIndex
 ver 1.6 : 18 Mar 13
 - Now support strong component analyzing and topological sorting
 ver 1.5 : 16 Feb 13
@@ -97,6 +133,7 @@ ver 1.0 : 14 Jan 13
 
 #include <vector>
 #include <unordered_map>
+#include <algorithm>
 #include <string>
 #include "XmlWriter.h"
 #include "XmlReader.h"
@@ -119,6 +156,7 @@ namespace GraphLib
 		Vertex(V v, size_t id);
 		Vertex(V v);
 		void add(Edge& edge);
+		void clear();
 		// Vertex(const Vertex<V,E>& v);                  compiler generated is correct
 		// Vertex<V,E>& operator=(const Vertex<V,E>& v);  compiler generated is correct
 		Edge& operator[](size_t i);
@@ -162,6 +200,10 @@ namespace GraphLib
 	template<typename V, typename E>
 	void Vertex<V,E>::add(Edge& edge) { _edges.push_back(edge); }
 
+	//----< remove all edges of vertex >---------------------------
+	template<typename V, typename E>
+	void Vertex<V,E>::clear() { _edges.clear(); }
+
 	//----< index non-const vertex's edges >-----------------------
 	template<typename V, typename E>
 	typename Vertex<V,E>::Edge& Vertex<V,E>::operator[](size_t i) { return _edges[i]; }
@@ -205,9 +247,13 @@ namespace GraphLib
 		template<typename F>
 		void dfs(F f);
 		size_t addOrFindVertexByVal(const V& val);
+		void reserve(size_t n);
+		void rebuildValueIndex();
+		std::vector<size_t> removeVertices(const std::vector<bool>& isRemoved);
 	private:
 		std::vector< Vertex<V,E> > adj;
 		std::unordered_map<size_t, size_t> idMap; // id maps to graph index
+		std::unordered_map<V, size_t> valMap; // value maps to graph index of first vertex holding it
 		template<typename F>
 		void dfsCore(Vertex<V,E>& v, F f);
 		template<typename F>
@@ -236,6 +282,60 @@ namespace GraphLib
 	{ 
 		adj.push_back(v);
 		idMap[v.id()] = adj.size() - 1;
+		valMap.insert(std::make_pair(v.value(), adj.size() - 1));	// keeps the first vertex of a value
+	}
+	//----< reserve room for n vertices, avoids rehashing while building >--
+	template<typename V, typename E>
+	void Graph<V,E>::reserve(size_t n)
+	{
+		adj.reserve(n);
+		idMap.reserve(n);
+		valMap.reserve(n);
+	}
+	//----< rebuild value index, needed after values are changed >--------
+	template<typename V, typename E>
+	void Graph<V,E>::rebuildValueIndex()
+	{
+		valMap.clear();
+		for(size_t i=0; i<adj.size(); ++i)
+			valMap.insert(std::make_pair(adj[i].value(), i));
+	}
+	//----< remove marked vertices and the edges to them >---------
+	// returns the index each vertex has now, (size_t)-1 if removed
+	template<typename V, typename E>
+	std::vector<size_t> Graph<V,E>::removeVertices(const std::vector<bool>& isRemoved)
+	{
+		std::vector<size_t> newIndex(adj.size(), (size_t)-1);
+		size_t kept = 0;
+		for(size_t i=0; i<adj.size(); ++i)
+		{
+			if(i >= isRemoved.size() || !isRemoved[i])
+				newIndex[i] = kept++;
+		}
+		if(kept == adj.size())
+			return newIndex;
+		std::vector< Vertex<V,E> > left;
+		left.reserve(kept);
+		for(size_t i=0; i<adj.size(); ++i)
+		{
+			if(newIndex[i] == (size_t)-1)
+				continue;
+			left.push_back(adj[i]);
+			left.back().clear();
+			for(auto edge : adj[i])
+			{
+				if(newIndex[edge.first] == (size_t)-1)
+					continue;
+				edge.first = (int)newIndex[edge.first];
+				left.back().add(edge);
+			}
+		}
+		adj.swap(left);
+		idMap.clear();
+		for(size_t i=0; i<adj.size(); ++i)
+			idMap[adj[i].id()] = i;
+		rebuildValueIndex();
+		return newIndex;
 	}
 	//----< return number of vertices in graph's collection >------
 	template<typename V, typename E>
@@ -319,14 +419,317 @@ namespace GraphLib
 	//----< return a reference to one vertex with specific value, will create one when it does not exist >-----
 	template<typename V, typename E>
 	size_t Graph<V,E>::addOrFindVertexByVal(const V& val) {
-		iterator it = std::find_if(begin(), end(), [&val] (Vertex<V,E>& _v) {
-			if (_v.value() == val) return true; else return false;
-		});
-		if (it!=end()) return findVertexIndexById(it->id());
+		typename std::unordered_map<V, size_t>::iterator it = valMap.find(val);
+		if (it!=valMap.end()) return it->second;
 		addVertex(Vertex<V,E>(val));
 		return size()-1;	// last added vertex
 	}
 
+	///////////////////////////////////////////////////////////////
+	// Adjacency class, read-only child indices of all vertices
+	// children of vertex i are targets[offsets[i]] .. targets[offsets[i+1]-1]
+
+	class Adjacency
+	{
+	public:
+		Adjacency() : offsets(1, 0) {}
+		size_t size() const { return offsets.size() - 1; }	// number of vertices
+		size_t begin(size_t i) const { return offsets[i]; }	// first edge of vertex i
+		size_t end(size_t i) const { return offsets[i+1]; }	// one past last edge of vertex i
+		size_t degree(size_t i) const { return offsets[i+1] - offsets[i]; }
+		size_t operator[](size_t k) const { return targets[k]; }	// child index of edge k
+		template<typename V, typename E>
+		void assign(Graph<V,E>& g);
+	private:
+		std::vector<size_t> offsets;
+		std::vector<size_t> targets;
+	};
+	//----< copy edges of graph g, in order >--------------------
+	template<typename V, typename E>
+	void Adjacency::assign(Graph<V,E>& g)
+	{
+		offsets.assign(1, 0);
+		offsets.reserve(g.size() + 1);
+		targets.clear();
+		for(auto& vert : g)
+		{
+			for(auto edge : vert)
+				targets.push_back(edge.first);
+			offsets.push_back(targets.size());
+		}
+	}
+
+	///////////////////////////////////////////////////////////////
+	// EdgeBuilder class, bulk edge insertion into a graph
+	// edges are appended without checks, finalize removes those
+	// already in the graph or added before, keeping the first one,
+	// so the graph ends up as if addEdge was called for each of them
+
+	template<typename V, typename E>
+	class EdgeBuilder
+	{
+	public:
+		EdgeBuilder(Graph<V,E>& g) : gr(g) {}
+		void reserve(size_t n) { pending.reserve(n); }
+		void add(E eVal, size_t parentIndex, size_t childIndex);
+		void finalize();
+		const Adjacency& adjacency() const { return adj; }
+	private:
+		struct Record	// an edge, existing or pending, while sorting
+		{
+			size_t parent, child, order;
+			const E* pVal;
+			bool operator<(const Record& r) const
+			{
+				if(parent != r.parent) return parent < r.parent;
+				if(child != r.child) return child < r.child;
+				return order < r.order;
+			}
+		};
+		Graph<V,E>& gr;
+		std::vector< std::pair<size_t, typename Vertex<V,E>::Edge> > pending;	// parent index, edge
+		Adjacency adj;
+		EdgeBuilder<V,E>& operator=(const EdgeBuilder<V,E>&);
+	};
+	//----< append edge from parent to child, no duplicate check >--
+	template<typename V, typename E>
+	void EdgeBuilder<V,E>::add(E eVal, size_t parentIndex, size_t childIndex)
+	{
+		if(childIndex >= gr.size())
+			throw std::exception("no edge child");
+		if(parentIndex >= gr.size())
+			throw std::exception("no edge parent");
+		typename Vertex<V,E>::Edge e;
+		e.first = childIndex;
+		e.second = eVal;
+		pending.push_back(std::make_pair(parentIndex, e));
+	}
+	//----< remove duplicates, add pending edges to graph >--------
+	template<typename V, typename E>
+	void EdgeBuilder<V,E>::finalize()
+	{
+		// existing edges come first, so they win over pending ones
+		std::vector<Record> recs;
+		size_t order = 0;
+		for(size_t i=0; i<gr.size(); ++i)
+		{
+			for(auto it=gr[i].begin(); it!=gr[i].end(); ++it)
+			{
+				Record r = { i, (size_t)it->first, order++, &it->second };
+				recs.push_back(r);
+			}
+		}
+		size_t existing = order;
+		for(size_t k=0; k<pending.size(); ++k)
+		{
+			Record r = { pending[k].first, (size_t)pending[k].second.first, order++, &pending[k].second.second };
+			recs.push_back(r);
+		}
+		std::sort(recs.begin(), recs.end());
+		// within a run of same parent and child, keep first of each value
+		std::vector<bool> keep(pending.size(), false);
+		for(size_t run=0; run<recs.size(); )
+		{
+			size_t last = run + 1;
+			while(last<recs.size() && recs[last].parent==recs[run].parent && recs[last].child==recs[run].child)
+				++last;
+			for(size_t k=run; k<last; ++k)
+			{
+				if(recs[k].order < existing)
+					continue;
+				bool dup = false;
+				for(size_t j=run; j<k && !dup; ++j)
+					dup = (recs[j].order < existing || keep[recs[j].order - existing]) && *recs[j].pVal == *recs[k].pVal;
+				keep[recs[k].order - existing] = !dup;
+			}
+			run = last;
+		}
+		for(size_t k=0; k<pending.size(); ++k)
+		{
+			if(keep[k])
+				gr[pending[k].first].add(pending[k].second);
+		}
+		pending.clear();
+		adj.assign(gr);
+	}
+
+	///////////////////////////////////////////////////////////////
+	// CSRGraph class, immutable compressed sparse row copy of a graph
+	// vertex i keeps its index, edges are an Adjacency, values are
+	// kept apart from edges, so analyses scan flat arrays
+
+	template<typename V, typename E>
+	class CSRGraph
+	{
+	public:
+		typedef std::vector<size_t> indexArray;
+		CSRGraph(Graph<V,E>& g);
+		size_t size() const { return values.size(); }
+		const V& value(size_t i) const { return values[i]; }
+		size_t id(size_t i) const { return ids[i]; }
+		const Adjacency& edges() const { return adj; }
+		const E& edgeValue(size_t k) const { return edgeValues[k]; }
+		indexArray inDegrees(bool countSelfLoops=true) const;
+		std::vector<bool> reachableFrom(size_t v) const;
+		void strongComponents(std::vector<indexArray>& components, indexArray& componentOf, const std::vector<bool>* pWithin=0) const;
+		indexArray topologicalOrder() const;
+	private:
+		Adjacency adj;
+		std::vector<V> values;
+		indexArray ids;
+		std::vector<E> edgeValues;	// value of edge k
+		static size_t none() { return (size_t)-1; }
+	};
+	//----< copy vertices and edges of g >-----------------------
+	template<typename V, typename E>
+	CSRGraph<V,E>::CSRGraph(Graph<V,E>& g)
+	{
+		adj.assign(g);
+		values.reserve(g.size());
+		ids.reserve(g.size());
+		edgeValues.reserve(adj.begin(g.size()));
+		for(auto& vert : g)
+		{
+			values.push_back(vert.value());
+			ids.push_back(vert.id());
+			for(auto it=vert.begin(); it!=vert.end(); ++it)
+				edgeValues.push_back(it->second);
+		}
+	}
+	//----< number of edges entering each vertex >---------------
+	template<typename V, typename E>
+	typename CSRGraph<V,E>::indexArray CSRGraph<V,E>::inDegrees(bool countSelfLoops) const
+	{
+		indexArray degree(size(), 0);
+		for(size_t i=0; i<size(); ++i)
+		{
+			for(size_t k=adj.begin(i); k<adj.end(i); ++k)
+			{
+				if(countSelfLoops || adj[k] != i)
+					++degree[adj[k]];
+			}
+		}
+		return degree;
+	}
+	//----< mark vertices reachable from v, v included >---------
+	template<typename V, typename E>
+	std::vector<bool> CSRGraph<V,E>::reachableFrom(size_t v) const
+	{
+		std::vector<bool> reached(size(), false);
+		indexArray stack(1, v);
+		reached[v] = true;
+		while(!stack.empty())
+		{
+			size_t u = stack.back();
+			stack.pop_back();
+			for(size_t k=adj.begin(u); k<adj.end(u); ++k)
+			{
+				if(!reached[adj[k]])
+				{
+					reached[adj[k]] = true;
+					stack.push_back(adj[k]);
+				}
+			}
+		}
+		return reached;
+	}
+	//----< Tarjan's algorithm with an explicit stack >------------
+	// roots are taken in vertex order, components are found in
+	// reverse topological order and appended to components; with
+	// pWithin, only marked vertices and the edges between them are
+	// searched, the others are left in no component
+	template<typename V, typename E>
+	void CSRGraph<V,E>::strongComponents(std::vector<indexArray>& components, indexArray& componentOf, const std::vector<bool>* pWithin) const
+	{
+		indexArray indexOf(size(), none()), lowlink(size(), 0), stack;
+		std::vector<bool> onStack(size(), false);
+		std::vector< std::pair<size_t, size_t> > path;	// vertex, next edge to visit
+		componentOf.assign(size(), none());
+		size_t counter = 0;
+		for(size_t root=0; root<size(); ++root)
+		{
+			if(indexOf[root] != none() || (pWithin && !(*pWithin)[root]))
+				continue;
+			path.push_back(std::make_pair(root, adj.begin(root)));
+			indexOf[root] = lowlink[root] = counter++;
+			stack.push_back(root);
+			onStack[root] = true;
+			while(!path.empty())
+			{
+				size_t v = path.back().first;
+				if(path.back().second < adj.end(v))
+				{
+					size_t w = adj[path.back().second++];
+					if(pWithin && !(*pWithin)[w])
+						continue;
+					if(indexOf[w] == none())	// descend
+					{
+						path.push_back(std::make_pair(w, adj.begin(w)));
+						indexOf[w] = lowlink[w] = counter++;
+						stack.push_back(w);
+						onStack[w] = true;
+					}
+					else if(onStack[w] && lowlink[v] > indexOf[w])
+						lowlink[v] = indexOf[w];
+					continue;
+				}
+				path.pop_back();
+				if(!path.empty() && lowlink[path.back().first] > lowlink[v])
+					lowlink[path.back().first] = lowlink[v];
+				if(lowlink[v] == indexOf[v])	// v is the root of a component
+				{
+					indexArray c;
+					do {
+						c.push_back(stack.back());
+						stack.pop_back();
+						onStack[c.back()] = false;
+						componentOf[c.back()] = components.size();
+					} while(c.back() != v);
+					components.push_back(c);
+				}
+			}
+		}
+	}
+	//----< vertex indices, each before the vertices it links to >--
+	// dfs from vertices without parents, self loops ignored, then
+	// from any vertex left, which happens only when there is a cycle
+	template<typename V, typename E>
+	typename CSRGraph<V,E>::indexArray CSRGraph<V,E>::topologicalOrder() const
+	{
+		indexArray order, degree = inDegrees(false);
+		order.reserve(size());
+		std::vector<bool> visited(size(), false);
+		std::vector< std::pair<size_t, size_t> > path;	// vertex, next edge to visit
+		for(size_t pass=0; pass<2; ++pass)
+		{
+			for(size_t root=0; root<size(); ++root)
+			{
+				if(visited[root] || (pass == 0 && degree[root] != 0))
+					continue;
+				visited[root] = true;
+				path.push_back(std::make_pair(root, adj.begin(root)));
+				while(!path.empty())
+				{
+					size_t v = path.back().first;
+					if(path.back().second < adj.end(v))
+					{
+						size_t w = adj[path.back().second++];
+						if(!visited[w])	// visit children first
+						{
+							visited[w] = true;
+							path.push_back(std::make_pair(w, adj.begin(w)));
+						}
+						continue;
+					}
+					path.pop_back();
+					order.push_back(v);
+				}
+			}
+		}
+		std::reverse(order.begin(), order.end());
+		return order;
+	}
+
 	//----< convert E to string >--------------------------
 	template<typename V>
 	std::string ToString(V i)
@@ -433,96 +836,109 @@ namespace GraphLib
 	// strong connected components searcher
 	template <typename V, typename E>
 	class SCCSearcher {
-		typedef std::pair<size_t, size_t> vertexInfo;	// this is a pair of lowlink and index for vertex
 		typedef std::vector<size_t> strongComponent;	// collection of vertex index
 		typedef std::vector<strongComponent> strongComponents;
 		typedef std::vector<size_t> strongComponentList;	// an array of strong component index.  NOTICE, it is only index
 		typedef Graph<std::string, size_t> dGraph;	// a condensed graph used for topological sorting, vertex value is strong component's value set, edge value doesn't really matter
 		typedef Vertex<std::string, size_t> dVertex;	// dependency vertex, again, edge doesn't matter
 		typedef Graph<V,E> graph;
-		typedef Vertex<V,E> vertex;
 		graph* pGraph;
 		dGraph d_Graph;
-		size_t index;
-		strongComponent vStack;
-		std::unordered_map<size_t, vertexInfo> infoMap;	// key=vertex.index, value={lowlink, index}
 		strongComponents* SCCs;	// strong components list
+		strongComponent componentOf;	// vertex index -> strong component index
 
 		//----< create condensed map vertex from strong component vertex set >--------------------------
-		void createCondensedVertex(std::unordered_map<size_t, size_t> & idSCCMap) {
+		void createCondensedVertex(const CSRGraph<V,E>& csr) {
 			// mapping vertex with strong component value
 			for (size_t i=0;i<SCCs->size();i++) {
 				std::ostringstream val;
 				val <<"{ ";
 				for (size_t vIndex : (*SCCs)[i]) // for each vertex in one strong component
-					val << (*pGraph)[vIndex].value() << " ";
+					val << csr.value(vIndex) << " ";
 				val <<"}";
 				d_Graph.addVertex(dVertex(val.str()));
-				for (size_t vIndex : (*SCCs)[i])
-					idSCCMap[vIndex]=i;
 			}
 		}
 
 		//----< create consdensed map edge >--------------------------
-		void createCondensedEdge(std::unordered_map<size_t, size_t> & idSCCMap) {
+		void createCondensedEdge(const CSRGraph<V,E>& csr, const strongComponent& componentOf) {
+			const Adjacency& adj = csr.edges();
+			EdgeBuilder<std::string, size_t> builder(d_Graph);
 			for (size_t i=0;i<SCCs->size();i++) {
 				for (size_t vIndex : (*SCCs)[i]) { // for each vertex in one strong component
-					Vertex<V,E>& v=(*pGraph)[vIndex];
-					for (Vertex<V,E>::iterator it=v.begin();it!=v.end();it++) { // for each edge in this vertex
-						size_t sccIndex = idSCCMap[it->first];	// where this edge is linked to and find the strong component index
-						d_Graph.addEdge(0,d_Graph[i],d_Graph[sccIndex]);
-					}
+					for (size_t k=adj.begin(vIndex);k<adj.end(vIndex);k++) // for each edge in this vertex
+						builder.add(0,i,componentOf[adj[k]]);	// link to the strong component the edge leads to
 				}
 			}
-		}
-
-		//----< create condensed graph >--------------------------
-		void createCondensedGraph() {
-			std::unordered_map<size_t, size_t> idSCCMap;	// key=v.index, value=strongComponent.index where it is in
-			if (SCCs->size()<1) return;
-			createCondensedVertex(idSCCMap);
-			createCondensedEdge(idSCCMap);
+			builder.finalize();	// duplicates removed once, instead of on every edge
 		}
 	public:
 		//----< constructor >--------------------------
-		SCCSearcher(graph* g) : index(0), pGraph(g), SCCs(new strongComponents) {}
+		SCCSearcher(graph* g) : pGraph(g), SCCs(new strongComponents) {}
 
 		// search strong components
 		void search() {
 			if (pGraph->size()<1)
 				return;
-			// pick up the first vertex
-			pGraph->dfs<SCCSearcher<V,E>>((*pGraph)[0],*this);
-			createCondensedGraph();
+			CSRGraph<V,E> csr(*pGraph);
+			csr.strongComponents(*SCCs, componentOf);
+			createCondensedVertex(csr);
+			createCondensedEdge(csr, componentOf);
 		}
 
-		// Tarjan's algorithm
-		void operator() (vertex& v) {
-			v.mark()=true;	// manually mark this vertex as visited, as we call this function ourself
-			size_t vIndex = pGraph->findVertexIndexById(v.id());
-			vertexInfo& info = infoMap[vIndex] = vertexInfo(index,index);	// init both lowlink and index to index
-			index++;
-			vStack.push_back(vIndex);
-			// now traverse v's edge
-			for (vertex::iterator it=v.begin();it!=v.end();it++) {
-				vertex& child = (*pGraph)[it->first];
-				if (!child.mark()) {
-					(*this)(child);	// recursive call
-					if (info.first > infoMap[it->first].first) info.first=infoMap[it->first].first;	// update lowlink
+		// search again after the edges of changed vertices changed, and vertices were added or removed;
+		// newIndex gives the index now of each vertex searched before, (size_t)-1 if removed
+		// only the components reachable from a changed, new or removed vertex can change, and only
+		// they are searched again, the others are kept
+		void update(const strongComponent& changed, const strongComponent& newIndex) {
+			const size_t none = (size_t)-1;
+			CSRGraph<V,E> csr(*pGraph);
+			std::vector<bool> isAffected(SCCs->size(), false);	// old components which lost or changed a vertex
+			strongComponent oldOf(csr.size(), none);	// vertex index now -> old strong component
+			for (size_t v=0;v<componentOf.size();v++) {
+				if (newIndex[v]==none) isAffected[componentOf[v]] = true;
+				else oldOf[newIndex[v]] = componentOf[v];
+			}
+			for (size_t v : changed)
+				if (oldOf[v]!=none) isAffected[oldOf[v]] = true;
+			// vertices searched again: new ones, those of affected components and all they reach
+			std::vector<bool> within(csr.size(), false);
+			strongComponent stack;
+			for (size_t v=0;v<csr.size();v++)
+				if (oldOf[v]==none || isAffected[oldOf[v]]) {
+					within[v] = true;
+					stack.push_back(v);
 				}
-				else if (std::find(vStack.begin(), vStack.end(), it->first)!=vStack.end())
-					if (info.first > infoMap[it->first].second) info.first=infoMap[it->first].second;
+			const Adjacency& adj = csr.edges();
+			while (!stack.empty()) {
+				size_t v = stack.back();
+				stack.pop_back();
+				for (size_t k=adj.begin(v);k<adj.end(v);k++)
+					if (!within[adj[k]]) {
+						within[adj[k]] = true;
+						stack.push_back(adj[k]);
+					}
 			}
-			// if current vertex is root
-			if (info.first == info.second) {
-				// strong component found
-				strongComponent c;
-				do {
-					c.push_back(vStack.back());
-					vStack.pop_back();
-				} while (c.back()!=vIndex);
-				SCCs->push_back(c);
+			// components out of reach keep their vertices, in their order
+			strongComponents kept;
+			strongComponent of(csr.size(), none);
+			for (size_t i=0;i<SCCs->size();i++) {
+				if (isAffected[i] || within[newIndex[(*SCCs)[i][0]]]) continue;
+				kept.push_back(strongComponent());
+				for (size_t vIndex : (*SCCs)[i]) {
+					kept.back().push_back(newIndex[vIndex]);
+					of[newIndex[vIndex]] = kept.size()-1;
+				}
 			}
+			strongComponent found;
+			csr.strongComponents(kept, found, &within);
+			for (size_t v=0;v<csr.size();v++)
+				if (within[v]) of[v] = found[v];
+			SCCs->swap(kept);
+			componentOf.swap(of);
+			d_Graph = dGraph();
+			createCondensedVertex(csr);
+			createCondensedEdge(csr, componentOf);
 		}
 
 		// return sorted strong componets
@@ -530,6 +946,11 @@ namespace GraphLib
 			return d_Graph;
 		}
 
+		// return vertex indices of each strong component, component i is vertex i of Graph()
+		const strongComponents& Components() const {
+			return *SCCs;
+		}
+
 		// out put strong components
 		void show() {
 			std::cout<<"\n\n Strong Components -----------";
@@ -44,6 +44,16 @@ semiexpression.cpp tokenizer.cpp /link setargv.obj
 
 Maintenance History:
 ====================
+ver 2.5 : 17 Oct 26
+- ScopeDetector tests its keywords in a KeywordSet
+- ScopeDetector keywords match whole tokens only; before, any token found
+  inside "|class|struct|union|enum|", e.g. "s" or "on", opened a scope too
+ver 2.4 : 17 Oct 26
+- names are qualified with the cached prefix of the known parent scope
+ver 2.3 : 17 Oct 26
+- rules declare the preconditions the parser dispatches on
+ver 2.2 : 17 Oct 26
+- rules compare interned token ids instead of strings
 ver 2.1 : 17 Mar 13
 - added reading more type of codes
 ver 2.0 : 01 Jun 11
@@ -56,8 +66,10 @@ ver 1.0 : 12 Jan 06
 
 */
 //
+#include <algorithm>
 #include <queue>
 #include <string>
+#include <vector>
 #include "Parser.h"
 #include "ITokCollection.h"
 /////////////////////////////////////
@@ -71,9 +83,10 @@ ver 1.0 : 12 Jan 06
 
 class BeginningOfScope : public IRule {
 public:
+	BeginningOfScope() { requireToken(Tok::LeftBrace); }
 	bool doTest(ITokCollection*& pTc) {
 		//std::cout << "\n--BeginningOfScope rule";
-		if(pTc->find("{") < pTc->length()) doActions(pTc);
+		if(pTc->find(Tok::LeftBrace) < pTc->length()) doActions(pTc);
 		return false;
 	}
 };
@@ -99,9 +112,10 @@ public:
 
 class EndOfScope : public IRule {
 public:
+	EndOfScope() { requireToken(Tok::RightBrace); }
 	bool doTest(ITokCollection*& pTc) {
 		//std::cout << "\n--EndOfScope rule";
-		if(pTc->find("}") < pTc->length()) doActions(pTc);
+		if(pTc->find(Tok::RightBrace) < pTc->length()) doActions(pTc);
 		return false;
 	}
 };
@@ -125,9 +139,10 @@ public:
 
 class PreprocStatement : public IRule {
 public:
+	PreprocStatement() { requireToken(Tok::Pound); }
 	bool doTest(ITokCollection*& pTc) {
 		//std::cout << "\n--PreprocStatement rule";
-		if(pTc->find("#") < pTc->length()) {
+		if(pTc->find(Tok::Pound) < pTc->length()) {
 			doActions(pTc);
 			return true;
 		}
@@ -140,19 +155,19 @@ public:
 
 class FunctionDefinition : public IRule {
 public:
-	bool isSpecialKeyWord(const std::string& tok) {
-		const static std::string keys[]
-		= { "for", "while", "switch", "if", "catch" };
-		for(int i=0; i<5; ++i)
-			if(tok == keys[i])
-				return true;
-		return false;
+	FunctionDefinition() {
+		requireEnd(EndsWithOpenBrace);
+		requireToken(Tok::LeftParen);
+	}
+	bool isSpecialKeyWord(TokId id) {
+		return id == Tok::For || id == Tok::While || id == Tok::Switch
+			|| id == Tok::If || id == Tok::Catch;
 	}
 	bool doTest(ITokCollection*& pTc) {
 		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{") {
-			size_t len = tc.find("(");
-			if(len < tc.length() && !isSpecialKeyWord(tc[len-1])) {
+		if(tc.id(tc.length()-1) == Tok::LeftBrace) {
+			size_t len = tc.find(Tok::LeftParen);
+			if(len < tc.length() && !isSpecialKeyWord(tc.id(len-1))) {
 				//std::cout << "\n--FunctionDefinition rule";
 				doActions(pTc);
 				return true;
@@ -179,17 +194,17 @@ class PushFunction : public IAction {
 public:
 	PushFunction(Repository* pRepos) : p_Repos(pRepos) {}
 	void doAction(ITokCollection*& pTc) {
-		size_t pos = pTc->find("(") - 1, _pos;
-		while (pos>0 && (*pTc)[pos]=="\n") pos--;
+		size_t pos = pTc->find(Tok::LeftParen) - 1, _pos;
+		while (pos>0 && pTc->id(pos)==Tok::NewLine) pos--;
 		while (pos>2 && (*pTc)[pos-1].find("::")!=std::string::npos && Helper::isLegalTemplatedVariable((*pTc)[pos-2]))
 			pos-=2;
-		if (pos>1 && (*pTc)[pos-1]=="~") pos--;	// destructor
+		if (pos>1 && pTc->id(pos-1)==Tok::Tilde) pos--;	// destructor
 		_pos = pos;
-		element parent_element = TokenProcessor::getKnownParentElem(p_Repos);
+		const element& parent_element = TokenProcessor::getKnownParentElem(p_Repos);	// valid until the stack changes
 		// push function scope
-		std::string name = parent_element.name +"::"+ TokenProcessor::getTypename(pTc,pos);
+		std::string name = TokenProcessor::getKnownParentPrefix(p_Repos) + TokenProcessor::getTypename(pTc,pos);
 		TokenProcessor::appendTemplate(name, TokenProcessor::getTypenameTemplate(pTc, pos=0));	// regardless of the pos
-		if ((*pTc)[pTc->find("(")-1]=="operator")	// operator() ()
+		if (pTc->id(pTc->find(Tok::LeftParen)-1)==Tok::Operator)	// operator() ()
 			name+="()";
 		element elem;
 		elem.type = "function";
@@ -210,22 +225,19 @@ public:
 class SimicolonDetector : public IRule
 {
 	// ignore some special phrases (see http://goo.gl/VC7Xn)
-	static bool isSpecialKeyWord(const std::string& tok)
+	static bool isSpecialKeyWord(TokId id)
 	{
-		const static std::string keys[]
-		= { "typedef", "typename", "return", "for", "while", "catch", "if" };
-		for(int i=0; i<7; ++i)
-			if(tok == keys[i])
-				return true;
-		return false;
+		return id == Tok::Typedef || id == Tok::Typename || id == Tok::Return
+			|| id == Tok::For || id == Tok::While || id == Tok::Catch || id == Tok::If;
 	}
 public:
+	SimicolonDetector() { requireEnd(EndsWithSemicolon); }
 	bool doTest(ITokCollection*& pTc)
 	{
 		ITokCollection& tc = *pTc;
-		if (tc.length()>1 && tc[tc.length()-1] == ";") {  // when .length()==1, means it is an empty phrase, or a {..};
+		if (tc.length()>1 && tc.id(tc.length()-1) == Tok::Semicolon) {  // when .length()==1, means it is an empty phrase, or a {..};
 			for (size_t i=0;i<tc.length()-1;i++)
-				if (isSpecialKeyWord(tc[i]))
+				if (isSpecialKeyWord(tc.id(i)))
 					return false;
 			// possible captured: statement (var=value), increment (var++), variable declaration (Type var;)
 			// function call (func()), function definition (void func()), anything (var;)
@@ -242,8 +254,12 @@ public:
 
 class UsingNamespaceDefinition : public IRule {
 public:
+	UsingNamespaceDefinition() {
+		requireLeading(Tok::Using);
+		requireToken(Tok::Namespace);
+	}
 	bool doTest(ITokCollection*& pTc) {
-		if ((*pTc)[0] == "using" && pTc->find("namespace")<pTc->length()) {
+		if (pTc->id(0) == Tok::Using && pTc->find(Tok::Namespace)<pTc->length()) {
 			doActions(pTc);
 			return true;
 		}
@@ -261,7 +277,7 @@ public:
 	void doAction(ITokCollection*& pTc) {
 		//std::cout<<"\n using namespace "<< pTc->show().c_str();
 		// delete public / private / protected
-		size_t pos=pTc->find("namespace")+1;
+		size_t pos=pTc->find(Tok::Namespace)+1;
 		while (pos<pTc->length() && Helper::isSpace((*pTc)[pos])) pos++;
 		std::string name=TokenProcessor::getTypename(pTc, pos);
 		if (!name.empty())
@@ -282,7 +298,7 @@ public:
 		std::string name = TokenProcessor::getTypename(pTc, pos);
 		if (name.empty())	// anonymous type
 			name="(anonymous type)";
-		name = TokenProcessor::getKnownParentElem(p_Repos).name+"::"+name;
+		name = TokenProcessor::getKnownParentPrefix(p_Repos)+name;
 		element elem;
 		elem.type = "type";
 		elem.name = name;
@@ -304,30 +320,36 @@ public:
 	PushTypeInheritance(Repository* pRepos) : p_Repos(pRepos) {}
 	void doAction(ITokCollection*& pTc)
 	{
-		element parent_elem = TokenProcessor::getKnownParentElem(p_Repos);
-		size_t pos = pTc->find(":")+1;
+		const element& parent_elem = TokenProcessor::getKnownParentElem(p_Repos);
+		size_t pos = pTc->find(Tok::Colon)+1;
 		std::string name = "(initial value)";	// to start the following progress
 		while (pos<pTc->length() && Helper::isLegalTemplatedVariable((*pTc)[pos]) && !name.empty()) {
 			name  = TokenProcessor::getTypename(pTc, pos);
 			//std::cout<<"\n inheritance "<<name;
 			p_Repos->Symbols()->declareType(name, parent_elem.name);
-			if (pos<pTc->length()-1 && (*pTc)[pos]==",") pos++;
+			if (pos<pTc->length()-1 && pTc->id(pos)==Tok::Comma) pos++;
 		}
 	}
 };
 
 ///////////////////////////////////////////////////////////////
 // rule to detect special statement, like "for", "while", "catch"
+// the keyword must be one with a reserved token id
 
 class BracketStatementDefinition : public IRule {
-	std::string keyword;
+	TokId keyword;
 public:
-	BracketStatementDefinition(const std::string & key): keyword(key) {}
+	BracketStatementDefinition(const std::string & key): keyword(TokenPool::reserved(key)) {
+		requireEnd(EndsWithOpenBrace | EndsWithSemicolon);
+		requireToken(Tok::LeftParen);
+		requireToken(keyword);
+	}
 	bool doTest(ITokCollection*& pTc) {
 		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{" || tc[tc.length()-1] == ";") {
-			size_t len = tc.find("(");	// check len>0 in case it's (statement);
-			if(len>0 && len < tc.length()-1 && tc[len-1]==keyword) {
+		TokId last = tc.id(tc.length()-1);
+		if(last == Tok::LeftBrace || last == Tok::Semicolon) {
+			size_t len = tc.find(Tok::LeftParen);	// check len>0 in case it's (statement);
+			if(len>0 && len < tc.length()-1 && tc.id(len-1)==keyword) {
 				doActions(pTc);
 				return true;
 			}
@@ -347,14 +369,14 @@ public:
 	PushBracketStatement(Repository* pRepos, std::string etype, std::string ename) 
 		: p_Repos(pRepos), eType(etype), eName(ename) {}
 	void doAction(ITokCollection*& pTc) {
-		size_t pos = pTc->find("(")+1;
-		std::string scopeNS = TokenProcessor::getKnownParentElem(p_Repos).name +"::"+ eName;
+		size_t pos = pTc->find(Tok::LeftParen)+1;
+		std::string scopeNS = TokenProcessor::getKnownParentPrefix(p_Repos) + eName;
 		TokenProcessor::readTokCollection(pTc, pos, p_Repos, scopeNS);
 		element elem;
 		elem.type = eType;
 		elem.name = scopeNS;
 		elem.lineCount = p_Repos->lineCount();
-		if((*pTc)[pTc->length()-1] == "{") {	// sometimes there is no scope follows
+		if(pTc->id(pTc->length()-1) == Tok::LeftBrace) {	// sometimes there is no scope follows
 			p_Repos->scopeStack().pop();
 			p_Repos->scopeStack().push(elem);
 		}
@@ -365,17 +387,20 @@ public:
 // detect scope
 
 class ScopeDetector : public IRule {
-	std::string keywords;
+	KeywordSet keywords;
 public:
-	ScopeDetector(std::string key) : keywords("|"+key+"|") {}
+	// key is a list of keywords separated by |, e.g. "class|struct", each matched as a whole token
+	ScopeDetector(std::string key) : keywords(key) {
+		requireEnd(EndsWithOpenBrace);
+	}
 	bool doTest(ITokCollection*& pTc) {
 		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == "{") {
+		if(tc.id(tc.length()-1) == Tok::LeftBrace) {
 			// after template
 			size_t pos=0;
 			TokenProcessor::getTypenameTemplate(pTc, pos);	// don't care the value, just move the pos
 			for (;pos<pTc->length() && Helper::isSpace(tc[pos]);pos++);
-			if (keywords.find(tc[pos])!=std::string::npos) {
+			if (keywords.contains(tc.id(pos))) {
 				doActions(pTc);
 				return true;
 			}
@@ -402,7 +427,7 @@ public:
 		std::string name = TokenProcessor::getTypename(pTc, pos);
 		if (name.empty()) name = eName;
 		if (insertNS)
-			name = TokenProcessor::getKnownParentElem(p_Repos).name+"::"+name;
+			name = TokenProcessor::getKnownParentPrefix(p_Repos)+name;
 		element elem;
 		elem.type = eType;
 		elem.name = name;
@@ -420,9 +445,9 @@ public:
 
 class PushField : public IAction {
 	Repository* p_Repos;
-	bool isSpecialWord(std::string const & str) {
-		static const std::string keys="|public|private|protected|case|";
-		return Helper::isSpace(str) || keys.find("|"+str+"|")!=std::string::npos;
+	bool isSpecialWord(std::string const & str, TokId id) {
+		return id == Tok::Public || id == Tok::Private || id == Tok::Protected
+			|| id == Tok::Case || Helper::isSpace(str);
 	}
 public:
 	PushField(Repository* pRepos) : p_Repos(pRepos) {}
@@ -431,7 +456,7 @@ public:
 		//std::cout<<"\n field "<< pTc->show().c_str();
 		// delete public / private / protected
 		size_t pos=0;
-		while (pos<pTc->length() && (isSpecialWord((*pTc)[pos]) || (*pTc)[pos].find(':')!=std::string::npos)) pos++;
+		while (pos<pTc->length() && (isSpecialWord((*pTc)[pos], pTc->id(pos)) || (*pTc)[pos].find(':')!=std::string::npos)) pos++;
 		// find the first word
 		TokenProcessor::readTokCollection(pTc, pos, p_Repos, TokenProcessor::getKnownParentElem(p_Repos).name);
 	}
@@ -446,15 +471,15 @@ public:
 	PushInclude(Repository* pRepos) : p_Repos(pRepos) {}
 	void doAction(ITokCollection*& pTc) {
 		ITokCollection& tc = *pTc;
-		if (tc[1]!="include") return;
+		if (tc.id(1)!=Tok::Include) return;
 		// read the < or "
 		size_t pos=2;
 		std::string inc;
 		while (pos<pTc->length() && Helper::isSpace((*pTc)[pos])) pos++;
-		if ((*pTc)[pos]=="<") {
+		if (pTc->id(pos)==Tok::Less) {
 			while (++pos<pTc->length() && (*pTc)[pos].find('>')==std::string::npos)
 				inc+=(*pTc)[pos];
-			if (pos<pTc->length() && (*pTc)[pos]!=">")
+			if (pos<pTc->length() && pTc->id(pos)!=Tok::Greater)
 				inc+=(*pTc)[pos].substr(0,(*pTc)[pos].length()-1);	// delete the last >
 		}
 		else
@@ -472,15 +497,15 @@ class PushArgument : public IAction
 public:
 	PushArgument(Repository* pRepos) : p_Repos(pRepos) {}
 	void doAction(ITokCollection*& pTc) {
-		element parent_elem = TokenProcessor::getKnownParentElem(p_Repos);
-		for (size_t pos=pTc->find("(")+1;pos<pTc->length()-1;) {
+		const element& parent_elem = TokenProcessor::getKnownParentElem(p_Repos);
+		for (size_t pos=pTc->find(Tok::LeftParen)+1;pos<pTc->length()-1;) {
 			// read one token, which is argument type
 			std::string type = TokenProcessor::getTypename(pTc, pos);
 			// read one token, which is argument variable
 			std::string argv = TokenProcessor::getTypename(pTc, pos);
 			if (type.empty() || argv.empty()) break;
 			// declare type, define argv
-			argv = parent_elem.name+"::"+argv;
+			argv = TokenProcessor::getKnownParentPrefix(p_Repos)+argv;
 			p_Repos->Symbols()->declareType(type, parent_elem.name);
 			p_Repos->Symbols()->defineType(argv);
 			pos<pTc->length() && (*pTc)[pos].find(',')!=std::string::npos ? pos++ : 0;
@@ -494,10 +519,14 @@ public:
 class TypeDefDefinition : public IRule
 {
 public:
+	TypeDefDefinition() {
+		requireEnd(EndsWithSemicolon);
+		requireToken(Tok::Typedef);
+	}
 	bool doTest(ITokCollection*& pTc)
 	{
 		ITokCollection& tc = *pTc;
-		if(tc[tc.length()-1] == ";" && tc.find("typedef")<tc.length()) {
+		if(tc.id(tc.length()-1) == Tok::Semicolon && tc.find(Tok::Typedef)<tc.length()) {
 			doActions(pTc);
 			return true;
 		}
@@ -516,20 +545,19 @@ public:
 	void doAction(ITokCollection*& pTc)
 	{
 		std::string alias;
-		size_t pos = pTc->find("(");
-		element parent_elem = TokenProcessor::getKnownParentElem(p_Repos);
+		size_t pos = pTc->find(Tok::LeftParen);
+		const element& parent_elem = TokenProcessor::getKnownParentElem(p_Repos);
 		if (pos>=pTc->length()) {	// doesn't find
-			pos = pTc->find("typedef")+1;
+			pos = pTc->find(Tok::Typedef)+1;
 			std::string name = TokenProcessor::getTypename(pTc,pos);
-			std::locale loc;
-			for (pos=pTc->length()-2;pos>0 && isspace((*pTc)[pos][0], loc);pos--) ;
+			for (pos=pTc->length()-2;pos>0 && Helper::isSpace((*pTc)[pos][0]);pos--) ;
 			alias = (*pTc)[pos];
 			// declare name, define alias
 			p_Repos->Symbols()->declareType(name, parent_elem.name);
 		}
 		else  // function pointer
 			alias = TokenProcessor::getTypename(pTc,pos);
-		alias = parent_elem.name +"::"+ alias;
+		alias = TokenProcessor::getKnownParentPrefix(p_Repos) + alias;
 		p_Repos->Symbols()->defineType(alias);
 	}
 };
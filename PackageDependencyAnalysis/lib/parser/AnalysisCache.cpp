@@ -0,0 +1,309 @@
+//////////////////////////////////////////////////////////////////////////
+//	AnalysisCache.cpp - Keeps what parsing found in each file across	//
+//	runs																//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Package Operations:
+===================
+Implements AnalysisCache, and tests it
+
+Public Interface:
+=================
+none
+
+Maintanence Information:
+========================
+Required files:
+---------------
+AnalysisCache.h, MappedFile.h, MappedFile.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.2 : added checked() and forget().
+- ver 0.1 : initial version.
+
+*/
+#include <fstream>
+#include <cstdio>
+#include <unordered_set>
+#include "AnalysisCache.h"
+#include "MappedFile.h"
+
+// first line of a cache file, changed whenever the format changes
+static const std::string cacheHeader = "PDA-CACHE 1\n";
+
+///////////////////////////////////////////////////////////////
+// reads the cache file format, every read fails once one has failed
+class CacheReader {
+public:
+	CacheReader(const char* data, size_t size) : _pos(data), _end(data+size), _ok(true) {}
+
+	bool ok() const { return _ok; }
+	bool atEnd() const { return _pos>=_end; }
+
+	// read one character
+	char tag() {
+		if (!_ok || _pos>=_end) return fail();
+		return *_pos++;
+	}
+
+	// read the exact text
+	bool expect(const std::string& text) {
+		if (!_ok || (size_t)(_end-_pos)<text.length() || text.compare(0, text.length(), _pos, text.length())!=0)
+			return fail()!=0;
+		_pos += text.length();
+		return true;
+	}
+
+	// read an unsigned decimal number
+	unsigned long long number() {
+		unsigned long long n = 0;
+		if (!_ok || _pos>=_end || *_pos<'0' || *_pos>'9') return fail();
+		while (_pos<_end && *_pos>='0' && *_pos<='9')
+			n = n*10 + (*_pos++ - '0');
+		return n;
+	}
+
+	// read a string written as length:bytes
+	std::string str() {
+		size_t length = (size_t)number();
+		if (!expect(":") || (size_t)(_end-_pos)<length) {
+			fail();
+			return "";
+		}
+		std::string s(_pos, length);
+		_pos += length;
+		return s;
+	}
+
+	// stop reading, the data is not what it should be
+	char fail() {
+		_ok = false;
+		return 0;
+	}
+
+private:
+	const char* _pos;
+	const char* _end;
+	bool _ok;
+};
+
+//----< write a string as length:bytes >-----------------------------------
+
+static void writeStr(std::ostream& out, const std::string& s) {
+	out << s.length() << ':' << s;
+}
+
+//----< write each distinct string of list as one line >--------------------
+
+static void writeList(std::ostream& out, char tag, const std::vector<std::string>& list) {
+	std::unordered_set<std::string> written;
+	for (const auto & s : list) {
+		if (!written.insert(s).second) continue;	// a repeated call adds nothing
+		out << tag << ' ';
+		writeStr(out, s);
+		out << '\n';
+	}
+}
+
+//----< stamp of the current content of file >-----------------------------
+
+bool AnalysisCache::stampOf(const std::string& file, Stamp& stamp) {
+	MappedFile f;
+	if (!f.open(file)) return false;
+	unsigned long long h = 14695981039346656037ull;
+	const unsigned char* p = (const unsigned char*)f.data();
+	for (size_t i=0;i<f.size();i++)
+		h = (h ^ p[i]) * 1099511628211ull;
+	stamp.size = f.size();
+	stamp.hash = h;
+	return true;
+}
+
+//----< read the cache file >----------------------------------------------
+
+bool AnalysisCache::load() {
+	MappedFile f;
+	if (!f.open(_cacheFile) || f.size()==0) return false;
+	CacheReader in(f.data(), f.size());
+	std::unordered_map<std::string, Entry> entries;
+	in.expect(cacheHeader);
+	while (in.ok() && !in.atEnd()) {
+		Entry entry;
+		entry.used = false;
+		in.expect("F ");
+		entry.stamp.size = in.number();
+		in.expect(" ");
+		entry.stamp.hash = in.number();
+		in.expect(" ");
+		std::string file = in.str();
+		in.expect("\n");
+		for (char tag=in.tag(); in.ok() && tag!='E'; tag=in.tag()) {
+			in.expect(" ");
+			switch (tag) {
+			case 'D': entry.facts.defined.push_back(in.str()); break;
+			case 'N': entry.facts.namespaces.push_back(in.str()); break;
+			case 'I': entry.facts.included.push_back(in.str()); break;
+			case 'T': {
+				std::string type = in.str();
+				in.expect(" ");
+				entry.facts.declared.push_back(std::make_pair(type, in.str()));
+				break;
+			}
+			default: in.fail();	// unknown line
+			}
+			in.expect("\n");
+		}
+		in.expect("\n");
+		if (in.ok()) entries[file] = entry;
+	}
+	if (!in.ok()) return false;	// a damaged cache is ignored, every file is parsed
+	std::lock_guard<std::mutex> lock(_lock);
+	_entries.swap(entries);
+	return true;
+}
+
+//----< write the entries used in this run >-------------------------------
+
+bool AnalysisCache::save() {
+	// copy the entries to write, so the parsers are not held up by the disk
+	std::vector<std::pair<std::string, Entry>> used;
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		for (const auto & it : _entries)
+			if (it.second.used) used.push_back(it);
+	}
+	std::string tmpFile = _cacheFile + ".tmp";
+	{
+		std::ofstream out(tmpFile.c_str(), std::ios::binary);
+		if (!out.good()) return false;
+		out << cacheHeader;
+		for (const auto & it : used) {
+			const Entry& entry = it.second;
+			out << "F " << entry.stamp.size << ' ' << entry.stamp.hash << ' ';
+			writeStr(out, it.first);
+			out << '\n';
+			writeList(out, 'D', entry.facts.defined);
+			std::unordered_set<SymbolTable::declaredType> written;
+			for (const auto & t : entry.facts.declared) {
+				if (!written.insert(t).second) continue;
+				out << "T ";
+				writeStr(out, t.first);
+				out << ' ';
+				writeStr(out, t.second);
+				out << '\n';
+			}
+			writeList(out, 'N', entry.facts.namespaces);
+			writeList(out, 'I', entry.facts.included);
+			out << "E\n";
+		}
+		if (!out.good()) return false;
+	}
+	// replace the old cache only with a complete one, rename() does so atomically
+	// on POSIX, but on Windows it fails when the target exists
+#ifdef _WIN32
+	std::remove(_cacheFile.c_str());
+#endif
+	return std::rename(tmpFile.c_str(), _cacheFile.c_str())==0;
+}
+
+//----< facts of file, if it is cached with this stamp >-------------------
+
+bool AnalysisCache::find(const std::string& file, const Stamp& stamp, FileFacts& facts) {
+	std::lock_guard<std::mutex> lock(_lock);
+	std::unordered_map<std::string, Entry>::iterator it = _entries.find(file);
+	if (it==_entries.end() || !(it->second.stamp==stamp))
+		return false;
+	it->second.used = true;
+	facts = it->second.facts;
+	_hits++;
+	return true;
+}
+
+//----< facts of file, if it was found or stored in this run >-------------
+
+bool AnalysisCache::checked(const std::string& file, FileFacts& facts) {
+	std::lock_guard<std::mutex> lock(_lock);
+	std::unordered_map<std::string, Entry>::iterator it = _entries.find(file);
+	if (it==_entries.end() || !it->second.used)
+		return false;
+	facts = it->second.facts;
+	return true;
+}
+
+//----< drop the entry of a changed file >---------------------------------
+
+void AnalysisCache::forget(const std::string& file) {
+	std::lock_guard<std::mutex> lock(_lock);
+	_entries.erase(file);
+}
+
+//----< keep facts of file found by parsing it >---------------------------
+
+void AnalysisCache::store(const std::string& file, const Stamp& stamp, const FileFacts& facts) {
+	std::lock_guard<std::mutex> lock(_lock);
+	Entry& entry = _entries[file];
+	entry.stamp = stamp;
+	entry.facts = facts;
+	entry.used = true;
+}
+
+#ifdef TEST_ANALYSISCACHE
+
+#include <iostream>
+#include "SymbolDatabase.h"
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing AnalysisCache\n ";
+	std::string file = (argc>1) ? argv[1] : "AnalysisCache.h";
+	AnalysisCache::Stamp stamp;
+	if (!AnalysisCache::stampOf(file, stamp)) {
+		std::cout << "\n  cannot read " << file << "\n\n";
+		return 1;
+	}
+	std::cout << "\n " << file << ": size " << stamp.size << ", hash " << stamp.hash;
+
+	// note what a table is told about the file
+	SymbolDatabase db;
+	FileFacts facts;
+	SymbolTable* pSymbol = db.create(file);
+	pSymbol->record(&facts);
+	pSymbol->defineType("::GraphLib::Graph<V, E>");
+	pSymbol->declareType("Vertex", "::GraphLib::Graph<V, E>");
+	pSymbol->declareType("Vertex", "::GraphLib::Graph<V, E>");
+	pSymbol->useNamespace("std");
+	pSymbol->includeFile("Vertex.h");
+	pSymbol->record(0);
+
+	AnalysisCache cache("test.cache");
+	cache.store(file, stamp, facts);
+	std::cout << "\n saved: " << cache.save();
+
+	AnalysisCache again("test.cache");
+	FileFacts found;
+	std::cout << "\n loaded: " << again.load();
+	std::cout << "\n found: " << again.find(file, stamp, found) << ", hits " << again.hits();
+	std::cout << "\n declared " << found.declared.size() << " type(s), first " << found.declared[0].first
+		<< " in " << found.declared[0].second;
+	stamp.hash++;
+	std::cout << "\n found after a change: " << again.find(file, stamp, found);
+
+	SymbolDatabase db2;
+	db2.create(file)->replay(found);
+	std::cout << "\n replayed types: " << db2.create(file)->types().size();
+	std::cout << "\n\n";
+}
+#endif
@@ -0,0 +1,135 @@
+#ifndef ANALYSISCACHE_H
+#define ANALYSISCACHE_H
+
+//////////////////////////////////////////////////////////////////////////
+//	AnalysisCache.h - Keeps what parsing found in each file across runs	//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+An AnalysisCache saves the FileFacts of every parsed file to a cache file,
+so the next run replays them into the SymbolTable instead of tokenizing and
+parsing the file again.  An entry is keyed by the file path and stamped with
+the size and a 64-bit FNV-1a hash of the file content; it is used only while
+the file still has that stamp, so an edited file is always parsed again.
+
+The cache file is text: a header line, then for every file an "F" line with
+the stamp and path, one line per fact and an "E" line.  Every string is
+written as its length, a colon and its bytes, so names with spaces or odd
+characters need no escaping.  Only the entries found or stored in this run
+are saved, so files which are gone drop out of the cache.
+
+A file found or stored once is trusted for the rest of the run: checked()
+returns its facts without reading the file again.  A caller which learns
+that a file changed, e.g. from a DirectoryWatcher, calls forget() so the
+file is stamped and parsed again.
+
+find(), checked(), store() and forget() lock the cache, so parsing threads
+may share one.
+
+Public Interface:
+=================
+AnalysisCache cache("analysis.cache");
+cache.load();	// false when there is no usable cache file
+AnalysisCache::Stamp stamp;
+if (AnalysisCache::stampOf(filePath, stamp)) {
+	FileFacts facts;
+	if (!cache.find(filePath, stamp, facts)) {
+		// parse the file, recording facts, then
+		cache.store(filePath, stamp, facts);
+	}
+}
+size_t n = cache.hits();	// files found in this run
+if (cache.checked(filePath, facts))	// found or stored before in this run
+	...
+cache.forget(filePath);	// file changed, drop its entry
+cache.save();
+
+Maintanence Information:
+========================
+Required files:
+---------------
+AnalysisCache.h, AnalysisCache.cpp, SymbolTable.h, MappedFile.h, MappedFile.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.2 added checked() and forget()
+- ver 0.1 first version
+
+*/
+
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include "SymbolTable.h"
+
+///////////////////////////////////////////////////////////////
+// AnalysisCache class
+class AnalysisCache {
+public:
+	///////////////////////////////////////////////////////////////
+	// what a file looked like when its facts were found
+	struct Stamp {
+		unsigned long long size;
+		unsigned long long hash;	// FNV-1a of the content
+		bool operator==(const Stamp& s) const { return size==s.size && hash==s.hash; }
+	};
+
+	explicit AnalysisCache(const std::string& cacheFile) : _cacheFile(cacheFile), _hits(0) {}
+
+	// read the cache file, return whether it could be used
+	bool load();
+
+	// write the entries found or stored in this run, return whether it succeeds
+	bool save();
+
+	// copy the facts of file into facts, false if it is not cached with this stamp
+	bool find(const std::string& file, const Stamp& stamp, FileFacts& facts);
+
+	// keep the facts of file, found by parsing it with this stamp
+	void store(const std::string& file, const Stamp& stamp, const FileFacts& facts);
+
+	// copy the facts of file into facts, false unless it was found or stored in this run
+	bool checked(const std::string& file, FileFacts& facts);
+
+	// drop the entry of file, which has changed or is gone
+	void forget(const std::string& file);
+
+	// number of files found in the cache in this run
+	size_t hits() const { return _hits; }
+
+	// stamp of the current content of file, false if it cannot be read
+	static bool stampOf(const std::string& file, Stamp& stamp);
+
+private:
+	///////////////////////////////////////////////////////////////
+	// cached facts of one file
+	struct Entry {
+		Stamp stamp;
+		FileFacts facts;
+		bool used;	// found or stored in this run
+	};
+
+	std::string _cacheFile;
+	std::unordered_map<std::string, Entry> _entries;	// file path -> its entry
+	std::mutex _lock;	// guards _entries and _hits
+	size_t _hits;
+
+	// prohibit copies and assignments
+	AnalysisCache(const AnalysisCache&);
+	AnalysisCache& operator=(const AnalysisCache&);
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef CHARCLASS_H
+#define CHARCLASS_H
+
+//////////////////////////////////////////////////////////////////////////
+//	CharClass.h - Character classes of the tokenizer and string helper	//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+Classifies a char with one lookup in a constant 256-entry table instead of
+constructing a std::locale and calling isspace / isalpha on every char.
+The classes are those of the "C" locale, which is the one the tokenizer
+and the string helper used: chars above 0x7f belong to no class.
+
+The table is initialized at compile time and shared by Toker and Helper.
+
+Public Interface:
+=================
+bool res = CharClass::isSpace(' ');
+bool res = CharClass::isDigit('0');
+bool res = CharClass::isIdentifier('_');	// letter, digit or _
+bool res = CharClass::isVariable('$');	// letter, digit, _ or $
+bool res = CharClass::isQuote('"');
+bool res = CharClass::is(chr, CharClass::Slash);
+
+Maintanence Information:
+========================
+Required files:
+---------------
+none
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.1 first version
+
+*/
+
+///////////////////////////////////////////////////////////////
+// CharClass namespace
+namespace CharClass {
+
+	enum {
+		Space = 0x01,		// \t \n \v \f \r and blank
+		Alpha = 0x02,		// A-Z a-z
+		Digit = 0x04,		// 0-9
+		Identifier = 0x08,	// letter, digit, _
+		Variable = 0x10,	// letter, digit, _ and $
+		Quote = 0x20,		// ' and "
+		Slash = 0x40		// /, may begin a comment
+	};
+
+	// class bits of every char, indexed by unsigned char
+	static const unsigned char table[256] = {
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00,	// 00 - 0f
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// 10 - 1f
+		0x01, 0x00, 0x20, 0x00, 0x10, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40,	// 20 - 2f
+		0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x1c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// 30 - 3f
+		0x00, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a,	// 40 - 4f
+		0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x00, 0x00, 0x00, 0x00, 0x18,	// 50 - 5f
+		0x00, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a,	// 60 - 6f
+		0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x1a, 0x00, 0x00, 0x00, 0x00, 0x00,	// 70 - 7f
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// 80 - 8f
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// 90 - 9f
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// a0 - af
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// b0 - bf
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// c0 - cf
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// d0 - df
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// e0 - ef
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,	// f0 - ff
+	};
+
+	// whether chr belongs to any of classes
+	inline bool is(char chr, unsigned char classes) {
+		return (table[(unsigned char)chr] & classes) != 0;
+	}
+
+	inline bool isSpace(char chr) { return is(chr, Space); }
+	inline bool isDigit(char chr) { return is(chr, Digit); }
+	inline bool isIdentifier(char chr) { return is(chr, Identifier); }
+	inline bool isVariable(char chr) { return is(chr, Variable); }
+	inline bool isQuote(char chr) { return is(chr, Quote); }
+}
+
+#endif
@@ -17,6 +17,21 @@
 #include "ConfigureParser.h"
 #include "SymbolTable.h"
 
+//----< constructor, parts are made by Build() >--------------------
+
+ConfigParseToConsole::ConfigParseToConsole(SymbolDatabase* pDatabase)
+	: pDb(pDatabase), pToker(0), pSemi(0), pParser(0), pRepo(0), pFR(0),
+	pBeginningOfScope(0), pHandlePush(0), pEndOfScope(0), pHandlePop(0),
+	pFunctionDefinition(0), pPushFunction(0), pSimicolonDetector(0),
+	pPushType(0), pPushTypeInheritance(0), pTypeDefDefinition(0), pPushTypeDef(0),
+	pPushArgument(0), pPushField(0), pPreprocStatement(0), pPushInclude(0),
+	pUsingNamespaceDefinition(0), pPushUsingNamespace(0)
+{
+	for (size_t i=0;i<4;i++) pSDetector[i] = 0;
+	for (size_t i=0;i<3;i++) pPushS[i] = 0;
+	for (size_t i=0;i<7;i++) pPushBS[i] = 0;
+	for (size_t i=0;i<6;i++) pBSDefinition[i] = 0;
+}
 //----< destructor releases all parts >------------------------------
 
 ConfigParseToConsole::~ConfigParseToConsole()
@@ -48,14 +63,27 @@ ConfigParseToConsole::~ConfigParseToConsole()
 	for (size_t i=0;i<7;i++) delete pPushBS[i];
 	for (size_t i=0;i<6;i++) delete pBSDefinition[i];
 }
-//----< attach toker to a file stream or stringstream >------------
+//----< attach toker to a file or string, resetting previous file's state >--
 
 bool ConfigParseToConsole::Attach(const std::string& name, bool isFile)
 {
 	if(pToker == 0)
 		return false;
-	pRepo->Symbols() = isFile ? SymbolTable::create(name) : SymbolTable::create("anonymous");	// anonymous file
+	pSemi->reset();	// ids of the last file's names are not needed any more
+	pRepo->scopeStack().clear();
+	pushFileScope();
+	pRepo->Symbols() = pRepo->Database()->create(isFile ? name : "anonymous");	// anonymous file
 	return pToker->attach(name, isFile);
+}
+//----< push a empty file scope, so that we need not to worry out of stack index >--
+
+void ConfigParseToConsole::pushFileScope()
+{
+	element fileScope;
+	fileScope.type="file";
+	//fileScope.name="";
+	fileScope.lineCount = 0;
+	pRepo->scopeStack().push(fileScope);
 }
 //----< Here's where alll the parts get assembled >----------------
 
@@ -68,7 +96,7 @@ Parser* ConfigParseToConsole::Build()
 		pToker->returnComments(false);	// set as do not return comment
 		pSemi = new SemiExp(pToker);
 		pParser = new Parser(pSemi);
-		pRepo = new Repository(pToker);
+		pRepo = new Repository(pToker, pDb);
 		// add code folding rules
 
 		pFR = new codeFoldingRules;
@@ -77,12 +105,7 @@ Parser* ConfigParseToConsole::Build()
 		initActions();
 		loadActions();
 		loadRules();
-		// push a empty file scope here, so that we need not to worry out of stack index
-		element fileScope;
-		fileScope.type="file";
-		//fileScope.name="";
-		fileScope.lineCount = 0;
-		pRepo->scopeStack().push(fileScope);
+		pushFileScope();
 
 		return pParser;
 	}
@@ -185,6 +208,51 @@ void ConfigParseToConsole::loadActions() {
 }
 
 
+//----< destructor releases all parsers built >--------------------
+
+ParserPool::~ParserPool()
+{
+	for (size_t i=0;i<all.size();i++)
+		delete all[i];
+}
+//----< take an idle parser, or build a new one, 0 if build fails >--
+
+ConfigParseToConsole* ParserPool::acquire()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		if (!idle.empty()) {
+			ConfigParseToConsole* pConfig = idle.back();
+			idle.pop_back();
+			return pConfig;
+		}
+	}
+	ConfigParseToConsole* pConfig = new ConfigParseToConsole(pDb);
+	if (!pConfig->Build()) {
+		delete pConfig;
+		return 0;
+	}
+	std::lock_guard<std::mutex> guard(lock);
+	all.push_back(pConfig);
+	return pConfig;
+}
+//----< give a parser back for reuse >-----------------------------
+
+void ParserPool::release(ConfigParseToConsole* pConfig)
+{
+	if (pConfig == 0)
+		return;
+	std::lock_guard<std::mutex> guard(lock);
+	idle.push_back(pConfig);
+}
+//----< number of parsers built >----------------------------------
+
+size_t ParserPool::size()
+{
+	std::lock_guard<std::mutex> guard(lock);
+	return all.size();
+}
+
 #ifdef TEST_CONFIGUREPARSER
 
 #include <queue>
@@ -204,13 +272,16 @@ int main(int argc, char* argv[])
 		return 1;
 	}
 
+	// one parser is built and reused for all files
+
+	SymbolDatabase db;
+	ConfigParseToConsole configure(&db);
+	Parser* pParser = configure.Build();
 	for(int i=1; i<argc; ++i)
 	{
 		std::cout << "\n  Processing file " << argv[i];
 		std::cout << "\n  " << std::string(16 + strlen(argv[i]),'-');
 
-		ConfigParseToConsole configure;
-		Parser* pParser = configure.Build();
 		try
 		{
 			if(pParser)
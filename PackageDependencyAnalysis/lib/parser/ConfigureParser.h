@@ -16,11 +16,26 @@ Module Operations:
 This module builds and configures parsers.  It builds the parser
 parts and configures them with application specific rules and actions.
 
+A built parser can be reused for many files: Attach() resets the token
+collection with its token pool and the scope stack and maps the next file,
+keeping the rules, actions and buffers.  A ParserPool hands out built
+parsers to parsing threads and takes them back, building a new one only
+when none is idle.
+
 Public Interface:
 =================
-ConfigParseToConsole conConfig;
+SymbolDatabase db;
+ConfigParseToConsole conConfig(&db);
 conConfig.Build();
 conConfig.Attach(someFileName);
+Parser* pParser = conConfig.parser();
+SymbolTable* pSymbol = conConfig.symbols();	// table of the attached file
+conConfig.Attach(anotherFileName);	// reuse for another file
+ParserPool pool(&db);
+ConfigParseToConsole* pConfig = pool.acquire();	// 0 if build fails
+pool.release(pConfig);
+size_t n = pool.size();	// number of parsers built
+SymbolDatabase* pDb = pool.database();
 
 Build Process:
 ==============
@@ -36,6 +51,12 @@ semiexpression.cpp tokenizer.cpp /link setargv.obj
 
 Maintenance History:
 ====================
+ver 2.4 : 17 Oct 26
+- added symbols() and database()
+ver 2.3 : 17 Oct 26
+- Attach() resets a built parser for the next file, added ParserPool
+ver 2.2 : 17 Oct 26
+- symbol tables are created in a SymbolDatabase passed to the constructor
 ver 2.1 : 27 Feb 13
 - Add some new rules
 ver 2.0 : 01 Jun 11
@@ -49,12 +70,15 @@ ver 1.0 : 12 Jan 06
 
 #include <string>
 #include <unordered_map>
+#include <vector>
+#include <mutex>
 #include "Parser.h"
 #include "SemiExpression.h"
 #include "Tokenizer.h"
 #include "ActionsAndRules.h"
 #include "FoldingRules.h"
 #include "SymbolTable.h"
+#include "SymbolDatabase.h"
 
 ///////////////////////////////////////////////////////////////
 // build parser that writes its output to console
@@ -62,13 +86,18 @@ ver 1.0 : 12 Jan 06
 class ConfigParseToConsole : IBuilder
 {
 public:
-	ConfigParseToConsole() {};
+	ConfigParseToConsole(SymbolDatabase* pDatabase);
 	~ConfigParseToConsole();
 	bool Attach(const std::string& name, bool isFile=true);
 	Parser* Build();
+	Parser* parser() { return pParser; }
+	SymbolTable* symbols() { return pRepo ? pRepo->Symbols() : 0; }
+	SymbolDatabase* database() { return pDb; }
 private:
 	// Builder must hold onto all the pieces
 
+	SymbolDatabase* pDb;	// not owned
+
 	Toker* pToker;
 	SemiExp* pSemi;
 	Parser* pParser;
@@ -118,6 +147,30 @@ private:
 	void loadRules();
 	void initActions();
 	void loadActions();
+	void pushFileScope();
+};
+
+///////////////////////////////////////////////////////////////
+// pool of built parsers, shared by parsing threads
+
+class ParserPool
+{
+public:
+	ParserPool(SymbolDatabase* pDatabase) : pDb(pDatabase) {}
+	~ParserPool();
+	ConfigParseToConsole* acquire();
+	void release(ConfigParseToConsole* pConfig);
+	size_t size();
+	SymbolDatabase* database() { return pDb; }
+private:
+	SymbolDatabase* pDb;	// not owned
+	std::mutex lock;	// guards all and idle
+	std::vector<ConfigParseToConsole*> all;	// every parser built, owned
+	std::vector<ConfigParseToConsole*> idle;	// parsers not acquired
+
+	// prohibit copies and assignments
+	ParserPool(const ParserPool&);
+	ParserPool& operator=(const ParserPool&);
 };
 
 
@@ -13,8 +13,8 @@
 void codeFoldingRules::MergeForCollections(ITokCollection*& pTc)
 {
   // have for(int i=0;
-  size_t posParen = pTc->find(")");
-  size_t posColon = pTc->find(":");
+  size_t posParen = pTc->find(Tok::RightParen);
+  size_t posColon = pTc->find(Tok::Colon);
   if(posParen != posColon + 2)
   {
     pTc->get(false);  // get i<N;
@@ -29,8 +29,8 @@ void codeFoldingRules::MergeOperatorTokens(ITokCollection*& pTc)
 
 void codeFoldingRules::doFold(ITokCollection*& pTc)
 {
-  if(pTc->find("for") < pTc->length())
+  if(pTc->find(Tok::For) < pTc->length())
     codeFoldingRules::MergeForCollections(pTc);
-  if(pTc->find("operator") < pTc->length())
+  if(pTc->find(Tok::Operator) < pTc->length())
     codeFoldingRules::MergeOperatorTokens(pTc);
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 #define FOLDINGRULES_H
 /////////////////////////////////////////////////////////////////////
 //  FoldingRules.h - declares ITokCollection folding rules         //
-//  ver 1.1                                                        //
+//  ver 1.2                                                        //
 //  Language:      Visual C++ 2010, SP1                            //
 //  Platform:      Dell Precision T7400, Win 7 Pro SP1             //
 //  Application:   Code Analysis Research                          //
@@ -38,6 +38,8 @@
 
   Maintenance History:
   ====================
+  ver 1.2 : 17 Oct 26
+  - tokens are looked up by interned id
   ver 1.1 : 10 Feb 13
   - modified FoldingRules.cpp to avoid folding for(auto x : C) {
   ver 1.0 : 02 Jan 11
@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////
+//	MappedFile.cpp - Read-only view of a whole file mapped into memory	//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Package Operations:
+===================
+Implements MappedFile, and tests it
+
+Public Interface:
+=================
+none
+
+Maintanence Information:
+========================
+Required files:
+---------------
+MappedFile.h
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.1 : initial version.
+
+*/
+#include "MappedFile.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//----< constructor, nothing mapped >--------------------------------------
+
+MappedFile::MappedFile() : _data(0), _size(0), _isOpen(false) {}
+
+//----< destructor, release the mapping >----------------------------------
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#ifdef _WIN32
+
+//----< map file for reading >---------------------------------------------
+
+bool MappedFile::open(const std::string& path) {
+	close();
+	HANDLE hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size)) {
+		CloseHandle(hFile);
+		return false;
+	}
+	if (size.QuadPart > 0) {	// empty file can't be mapped
+		HANDLE hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (hMap) {
+			_data = (const char*)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(hMap);	// the view keeps the mapping
+		}
+		if (!_data) {
+			CloseHandle(hFile);
+			return false;
+		}
+		_size = (size_t)size.QuadPart;
+	}
+	CloseHandle(hFile);
+	return _isOpen = true;
+}
+
+//----< release the mapping >----------------------------------------------
+
+void MappedFile::close() {
+	if (_data) UnmapViewOfFile(_data);
+	_data = 0;
+	_size = 0;
+	_isOpen = false;
+}
+
+#else
+
+//----< map file for reading >---------------------------------------------
+
+bool MappedFile::open(const std::string& path) {
+	close();
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		::close(fd);
+		return false;
+	}
+	if (st.st_size > 0) {	// empty file can't be mapped
+		void* p = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (p == MAP_FAILED) {
+			::close(fd);
+			return false;
+		}
+		madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+		_data = (const char*)p;
+		_size = (size_t)st.st_size;
+	}
+	::close(fd);	// the mapping stays valid
+	return _isOpen = true;
+}
+
+//----< release the mapping >----------------------------------------------
+
+void MappedFile::close() {
+	if (_data) munmap((void*)_data, _size);
+	_data = 0;
+	_size = 0;
+	_isOpen = false;
+}
+
+#endif
+
+#ifdef TEST_MAPPEDFILE
+
+#include <iostream>
+#include <algorithm>
+
+int main(int argc, char* argv[])
+{
+	std::cout << "\n  Testing MappedFile\n ";
+	MappedFile f;
+	std::cout << "\n missing file opens: " << f.open("no such file");
+	if (f.open(argc > 1 ? argv[1] : "MappedFile.h"))
+		std::cout << "\n " << f.size() << " characters, first line:\n "
+			<< std::string(f.data(), std::find(f.data(), f.data() + f.size(), '\n'));
+	std::cout << "\n\n";
+}
+#endif
@@ -0,0 +1,87 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+//////////////////////////////////////////////////////////////////////////
+//	MappedFile.h - Read-only view of a whole file mapped into memory	//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A MappedFile maps a file into memory for reading, so its content can be
+scanned as one contiguous block of characters without copying it through
+a stream.  The Toker reads its source from such a mapping and returns
+tokens as slices of it.
+
+On Windows the file is mapped with CreateFileMapping / MapViewOfFile,
+elsewhere with mmap.  File handles are closed as soon as the view is
+mapped.  An empty file opens fine and has no data.  The
+mapping is released by close(), by opening another file, or on
+destruction; pointers into it are invalid after that.
+
+Public Interface:
+=================
+MappedFile f;
+if (f.open(filePath))
+	std::string content(f.data(), f.size());
+bool res = f.isOpen();
+f.close();
+
+Maintanence Information:
+========================
+Required files:
+---------------
+MappedFile.h, MappedFile.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.1 first version
+
+*/
+
+#include <string>
+
+///////////////////////////////////////////////////////////////
+// MappedFile class
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	// map file for reading, return whether it succeeds
+	bool open(const std::string& path);
+
+	// release the mapping
+	void close();
+
+	// whether a file is mapped
+	bool isOpen() const { return _isOpen; }
+
+	// first character of the file, 0 when it is empty
+	const char* data() const { return _data; }
+
+	// number of characters in the file
+	size_t size() const { return _size; }
+
+private:
+	const char* _data;
+	size_t _size;
+	bool _isOpen;
+
+	// prohibit copies and assignments
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
+
+#endif
@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  Parser.cpp - Analyzes C++ language constructs                  //
-//  ver 1.3                                                        //
+//  ver 1.4                                                        //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
 //  Application:   Prototype for CSE687 Pr1, Sp09                  //
@@ -22,6 +22,9 @@
 void Parser::addRule(IRule* pRule)
 {
   rules.push_back(pRule);
+  for(size_t kind=0; kind<EndKindCount; ++kind)
+    if(pRule->acceptsEnd(1 << kind))
+      dispatch[kind].push_back(pRule);
 }
 //----< get next ITokCollection >------------------------------
 
@@ -39,14 +42,39 @@ bool Parser::next()
   return true;
 }
 
+//----< index of kind of last token, in dispatch >-------------
+
+size_t Parser::endKind()
+{
+  switch(pTokColl->id(pTokColl->length() - 1))
+  {
+  case Tok::LeftBrace:  return 0;
+  case Tok::RightBrace: return 1;
+  case Tok::Semicolon:  return 2;
+  case Tok::NewLine:    return 3;
+  default:              return 4;
+  }
+}
 //----< parse the SemiExp by applying all rules to it >--------
+//  only rules whose preconditions hold are tested, an empty
+//  collection is given to all of them
 
 bool Parser::parse()
 {
   bool succeeded = false;
-  for(size_t i=0; i<rules.size(); ++i)
+  if(pTokColl->length() == 0)
+  {
+    for(size_t i=0; i<rules.size(); ++i)
+    {
+      if(rules[i]->doTest(pTokColl))
+        succeeded = true;
+    }
+    return succeeded;
+  }
+  std::vector<IRule*>& candidates = dispatch[endKind()];
+  for(size_t i=0; i<candidates.size(); ++i)
   {
-    if(rules[i]->doTest(pTokColl))
+    if(candidates[i]->mayMatch(pTokColl) && candidates[i]->doTest(pTokColl))
       succeeded = true;
   }
   return succeeded;
@@ -57,6 +85,17 @@ void IRule::addAction(IAction *pAction)
 {
   actions.push_back(pAction);
 }
+//----< do leading and required tokens allow a match? >--------
+
+bool IRule::mayMatch(ITokCollection* pTc)
+{
+  if(leading != Tok::Unknown && pTc->id(0) != leading)
+    return false;
+  for(size_t i=0; i<required.size(); ++i)
+    if(pTc->find(required[i]) >= pTc->length())
+      return false;
+  return true;
+}
 //----< invoke all actions associated with a rule >------------
 
 void IRule::doActions(ITokCollection*& pTokColl)
@@ -92,7 +131,8 @@ int main(int argc, char* argv[])
     std::cout << "\n  Processing file " << argv[i];
     std::cout << "\n  " << std::string(16 + strlen(argv[i]),'-');
 
-    ConfigParseToConsole configure;
+    SymbolDatabase db;
+    ConfigParseToConsole configure(&db);
     Parser* pParser = configure.Build();
     try
     {
@@ -2,7 +2,7 @@
 #define PARSER_H
 /////////////////////////////////////////////////////////////////////
 //  Parser.h - Analyzes C++ language constructs                    //
-//  ver 1.3                                                        //
+//  ver 1.4                                                        //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
 //  Application:   Prototype for CSE687 Pr1, Sp09                  //
@@ -17,6 +17,16 @@
   applying a set of rules to the semi-expression, and for each rule
   that matches, a set of actions is invoked.
 
+  A rule may declare cheap preconditions: the kinds of last token it can
+  match ('{', '}', ';', the newline ending a preprocessor line, or any
+  other), a leading token, and tokens that must be present.  The parser
+  keeps, for every kind of last token, the rules that accept it in
+  registration order, and tests only those whose other preconditions
+  hold.  Preconditions must be declared before the rule is registered,
+  and must be implied by the rule's doTest(), so parsing gives the same
+  results as testing every rule.  An empty collection is offered to
+  every rule.
+
   Public Interface:
   =================
   Toker t(someFile);              // create tokenizer instance
@@ -25,6 +35,8 @@
   Rule1 r1;                       // create instance of a derived Rule class
   Action1 a1;                     // create a derived action
   r1.addAction(&a1);              // register action with the rule
+  r1.requireEnd(IRule::EndsWithOpenBrace); // optional preconditions
+  r1.requireToken(Tok::LeftParen);
   parser.addRule(&r1);            // register rule with parser
   while(se.getSemiExp())          // get semi-expression
     parser.parse();               //   and parse it
@@ -43,6 +55,9 @@
 
   Maintenance History:
   ====================
+  ver 1.4 : 17 Oct 26
+  - rules declare preconditions, parse() tests only the rules that
+    may match the last token of the collection
   ver 1.3 : 02 Jun 11
   - added use of folding rules in get();
   ver 1.2 : 17 Jan 09
@@ -91,14 +106,38 @@ public:
 class IRule
 {
 public:
+  // kinds of last token of a collection
+  enum {
+    EndsWithOpenBrace = 1, EndsWithCloseBrace = 2, EndsWithSemicolon = 4,
+    EndsWithNewLine = 8, EndsWithOther = 16, EndsWithAny = 31
+  };
+  IRule() : endKinds(EndsWithAny), leading(Tok::Unknown) {}
   virtual ~IRule() {}
   void addAction(IAction* pAction);
   void doActions(ITokCollection*& pTc);
   virtual bool doTest(ITokCollection*& pTc)=0;
+  void requireEnd(unsigned kinds);
+  void requireLeading(TokId id);
+  void requireToken(TokId id);
+  bool acceptsEnd(unsigned kind);
+  bool mayMatch(ITokCollection* pTc);
 protected:
   std::vector<IAction*> actions;
+private:
+  unsigned endKinds;
+  TokId leading;
+  std::vector<TokId> required;
 };
 
+inline void IRule::requireEnd(unsigned kinds) { endKinds = kinds; }
+
+inline void IRule::requireLeading(TokId id) { leading = id; }
+
+inline void IRule::requireToken(TokId id) { required.push_back(id); }
+
+inline bool IRule::acceptsEnd(unsigned kind) { return (endKinds & kind) != 0; }
+
+
 class FoldingRules
 {
 public:
@@ -120,9 +159,12 @@ public:
   bool parse();
   bool next();
 private:
+  enum { EndKindCount = 5 };
   ITokCollection* pTokColl;
   std::vector<IRule*> rules;
+  std::vector<IRule*> dispatch[EndKindCount];  // rules accepting each kind of last token
   FoldingRules* pFoldingRules;
+  size_t endKind();
 };
 
 inline Parser::Parser(ITokCollection* pTokCollection) : pTokColl(pTokCollection), pFoldingRules(new FoldingRules) {}
@@ -22,6 +22,7 @@ struct element
   std::string type;
   std::string name;
   size_t lineCount;
+  bool isKnown() const { return type != "unknown"; }
   std::string show()
   {
     std::ostringstream temp;
@@ -65,7 +66,14 @@ int main()
   testStack.push(item);
 
 
+  item.type = "unknown";
+  item.name = "";
+  item.lineCount = 93;
+  testStack.push(item);
+
   showStack<element>(testStack, false);
+  std::cout << "\n  known parent: " << testStack.knownParent().show();
+  std::cout << "\n  qualified name: " << testStack.knownPrefix() << "x";
   std::cout << std::endl;
 
   std::cout << "\n  Popping two items off ScopeStack";
@@ -75,6 +83,7 @@ int main()
   testStack.pop();
 
   showStack<element>(testStack, false);
+  std::cout << "\n  known parent: " << testStack.knownParent().show();
   std::cout << "\n\n";
 }
 
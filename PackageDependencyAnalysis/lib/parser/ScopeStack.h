@@ -16,6 +16,12 @@
   is an application specific type designed to hold whatever information you
   need to stack.
 
+  The elements are held in a contiguous vector.  For every depth the stack
+  also keeps the index of the nearest known element at or below it, where
+  known is decided by element::isKnown(), and that element's name followed
+  by "::", so the scope qualifying a new name is found without searching
+  or copying elements.  The bottom element serves when none is known.
+
   Public Interface:
   =================
   ScopeStack<element> stack;
@@ -23,6 +29,10 @@
   element elem;
   stack.push(elem);
   element popped = stack.pop();
+  element& last = stack.top();
+  element& parent = stack.knownParent();    // stack must not be empty
+  std::string name = stack.knownPrefix() + "x";  // "::" when empty
+  stack.clear();
 
   Required Files:
   ===============
@@ -34,6 +44,11 @@
 
   Maintenance History:
   ====================
+  ver 2.3 : 17 Oct 26
+  - elements are kept in a vector, added top(), knownParent() and
+    knownPrefix() with the nearest known element cached per depth
+  ver 2.2 : 17 Oct 26
+  - added clear(), so a stack can be reused for another file
   ver 2.1 : 02 Jun 11
   - changed ScopeStack type to single template argument intended to be
     an application specific type (usually a struct that holds whatever
@@ -43,23 +58,34 @@
   ver 1.0 : 31 Jan 11
   - first release
 */
-#include <list>
+#include <vector>
+#include <iostream>
+#include <string>
 
 // element is a application specific type.  It must provide a function:
-// std::string show() that returns a string display of its parts. see
-// test stub for an example.
+// std::string show() that returns a string display of its parts, a
+// function bool isKnown() telling whether it qualifies names declared
+// in it, and a std::string name. see test stub for an example.
 
 template<typename element>
 class ScopeStack {
 public:
-  typename typedef std::list<element>::iterator iterator;
+  typename typedef std::vector<element>::iterator iterator;
+  ScopeStack() : emptyPrefix("::") {}
   void push(const element& item);
   element pop();
+  void clear();
   size_t size();
+  element& top();
+  element& knownParent();
+  const std::string& knownPrefix();
   iterator begin();
   iterator end();
 private:
-  std::list<element> stack;
+  std::vector<element> stack;
+  std::vector<size_t> known;         // depth -> index of nearest known element
+  std::vector<std::string> prefixes; // index -> its name + "::", kept for reuse
+  std::string emptyPrefix;
 };
 
 template<typename element>
@@ -71,10 +97,41 @@ typename inline ScopeStack<element>::iterator ScopeStack<element>::begin() { ret
 template<typename element>
 typename inline ScopeStack<element>::iterator ScopeStack<element>::end() { return stack.end(); }
 
+template<typename element>
+inline element& ScopeStack<element>::top() { return stack.back(); }
+
+template<typename element>
+inline element& ScopeStack<element>::knownParent() { return stack[known.back()]; }
+
+template<typename element>
+inline const std::string& ScopeStack<element>::knownPrefix()
+{
+  if(stack.size() == 0)
+    return emptyPrefix;
+  return prefixes[known.back()];
+}
+
 template<typename element>
 void ScopeStack<element>::push(const element& item)
 {
+  size_t index = stack.size();
   stack.push_back(item);
+  if(index > 0 && !stack[index].isKnown())
+  {
+    known.push_back(known.back());
+    return;
+  }
+  known.push_back(index);
+  if(prefixes.size() <= index)
+    prefixes.resize(index + 1);
+  prefixes[index].assign(item.name).append("::");
+}
+
+template<typename element>
+void ScopeStack<element>::clear()
+{
+  stack.clear();
+  known.clear();
 }
 
 template<typename element>
@@ -82,6 +139,7 @@ element ScopeStack<element>::pop()
 { 
   element item = stack.back(); 
   stack.pop_back(); 
+  known.pop_back();
   return item; 
 }
 
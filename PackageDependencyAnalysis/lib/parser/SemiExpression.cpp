@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  SemiExpression.cpp - Collects tokens for code analysis         //
-//  ver 2.1                                                        //
+//  ver 2.4                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -14,7 +14,9 @@
 
 //----< construct SemiExp instance >---------------------------
 
-SemiExp::SemiExp(Toker* pTokr) : pToker(pTokr), Verbose(false),
+SemiExp::SemiExp(Toker* pTokr) : pToker(pTokr),
+                                 firstPos(Tok::ReservedCount, (size_t)-1),
+                                 trimmed(0), indexValid(true), Verbose(false),
                                  commentIsSemiExp(false), doReturnNewLines(true)
 {
 }
@@ -25,21 +27,13 @@ SemiExp::~SemiExp()
 }
 //----< is this a terminating token? >-------------------------
 
-bool SemiExp::isTerminator(std::string tok)
+bool SemiExp::isTerminator(const Token& tok, TokId id)
 {
-  if(tok.length() == 0)
-    return false;
-  if(tok == "{" || tok == "}" || tok == ";")
+  if(id == Tok::LeftBrace || id == Tok::RightBrace || id == Tok::Semicolon)
     return true;
-  if(tok == "\n")
-  {
-    size_t n = find("#");
-    if(n < length())
-      return true;
-  }
-  if(commentIsSemiExp && isComment(tok))
-    return true;
-  return false;
+  if(id == Tok::NewLine)
+    return find(Tok::Pound) < length();
+  return commentIsSemiExp && tok.length > 1 && isComment(tok.text);
 }
 //
 //----< collect a semi-expression >----------------------------
@@ -47,8 +41,9 @@ bool SemiExp::isTerminator(std::string tok)
 bool SemiExp::get(bool clear)
 {
   if(clear)
-    toks.clear();
-  std::string tok;
+    this->clear();
+  Token tok;
+  TokId id;
   do
   {
     if(pToker->isFileEnd())
@@ -57,17 +52,22 @@ bool SemiExp::get(bool clear)
         return true;
       return false;
     }
-    tok = pToker->getTok();
+    tok = pToker->getTokView();  // token is copied only when it is kept
+    id = pool.intern(tok.text, tok.length);
     if(Verbose)
     {
       if(tok != "\n")
-        std::cout << "\n--tok=" << tok << std::endl;
+        std::cout << "\n--tok=" << tok.str() << std::endl;
       else
         std::cout << "\n--tok=newline\n";
     }
-    if(tok != "\n" || doReturnNewLines)
-      toks.push_back(tok);
-  } while(!isTerminator(tok));
+    if(id != Tok::NewLine || doReturnNewLines)
+    {
+      index(id, ids.size());
+      ids.push_back(id);
+      toks.push_back(tok.str());
+    }
+  } while(!isTerminator(tok, id));
   trimFront();
   return true;
 }
@@ -76,6 +76,12 @@ bool SemiExp::get(bool clear)
 bool SemiExp::isComment(const std::string& tok)
 {
   if(tok.length() < 2) return false;
+  return isComment(tok.c_str());
+}
+//----< is token starting at tok, at least 2 chars, a comment? >--
+
+bool SemiExp::isComment(const char* tok)
+{
   if(tok[0] != '/') return false;
   if(tok[1] == '/' || tok[1] == '*') return true;
   return false;
@@ -88,6 +94,14 @@ std::string& SemiExp::operator[](int n)
     throw std::exception("SemiExp index out of range");
   return toks[n];
 }
+//----< interned id of token n >-------------------------------
+
+TokId SemiExp::id(size_t n)
+{
+  if(ids.size() <= n)
+    throw std::exception("SemiExp index out of range");
+  return ids[n];
+}
 //----< collect semi-expression as space-seperated string >----
 
 std::string SemiExp::show(bool showNewLines)
@@ -96,7 +110,7 @@ std::string SemiExp::show(bool showNewLines)
     return "";
   std::string temp;
   for(size_t i=0; i<toks.size(); ++i)
-    if(toks[i] != "\n" || showNewLines)
+    if(ids[i] != Tok::NewLine || showNewLines)
       temp.append(" ").append(toks[i]);
   return temp;
 }
@@ -105,23 +119,64 @@ std::string SemiExp::show(bool showNewLines)
 
 size_t SemiExp::find(const std::string& tok)
 {
-  for(size_t i=0; i<length(); ++i)
-    if(tok == toks[i])
+  TokId id = pool.find(tok);
+  if(id == Tok::Unknown)
+    return length();
+  return find(id);
+}
+//----< is token with this id found in semi-expression? >------
+
+size_t SemiExp::find(TokId id)
+{
+  if(id < Tok::ReservedCount)
+  {
+    if(!indexValid)
+      buildIndex();
+    size_t pos = firstPos[id];
+    if(pos == (size_t)-1)
+      return length();
+    if(pos >= trimmed)
+      return pos - trimmed;
+    // its first token was removed from front, look for the next one
+  }
+  for(size_t i=0; i<ids.size(); ++i)
+    if(ids[i] == id)
       return i;
   return length();
 }
-//----< remove tok if found in semi-expression >---------------
+//----< record position of first token with a reserved id >--
 
-bool SemiExp::remove(const std::string& tok)
+void SemiExp::index(TokId id, size_t pos)
 {
-  std::vector<std::string>::iterator it;
-  it = std::find(toks.begin(),toks.end(),tok);
-  if(it != toks.end())
+  if(id < Tok::ReservedCount && firstPos[id] == (size_t)-1)
   {
-    toks.erase(it);
-    return true;
+    firstPos[id] = pos + trimmed;
+    indexedIds.push_back(id);
   }
-  return false;
+}
+//----< forget all recorded positions >------------------------
+
+void SemiExp::resetIndex()
+{
+  for(size_t i=0; i<indexedIds.size(); ++i)
+    firstPos[indexedIds[i]] = (size_t)-1;
+  indexedIds.clear();
+  trimmed = 0;
+  indexValid = true;
+}
+//----< record positions again after tokens were edited >------
+
+void SemiExp::buildIndex()
+{
+  resetIndex();
+  for(size_t i=0; i<ids.size(); ++i)
+    index(ids[i], i);
+}
+//----< remove tok if found in semi-expression >---------------
+
+bool SemiExp::remove(const std::string& tok)
+{
+  return remove(find(tok));
 }
 //----< remove tok at specified indes >------------------------
 
@@ -129,10 +184,24 @@ bool SemiExp::remove(size_t i)
 {
   if(i<0 || toks.size()<=i)
     return false;
-  std::vector<std::string>::iterator it = toks.begin();
-    toks.erase(it+i);
+  toks.erase(toks.begin()+i);
+  ids.erase(ids.begin()+i);
+  if(i == 0)
+    ++trimmed;
+  else
+    indexValid = false;
   return true;
 }
+//----< remove n tokens at front, shifting the rest once >-----
+
+void SemiExp::removeFront(size_t n)
+{
+  if(n > toks.size())
+    n = toks.size();
+  toks.erase(toks.begin(), toks.begin()+n);
+  ids.erase(ids.begin(), ids.begin()+n);
+  trimmed += n;
+}
 //----< merge from firstTok to token before secondTok >--------
 
 bool SemiExp::merge(const std::string& firstTok, const std::string& secondTok)
@@ -142,9 +211,11 @@ bool SemiExp::merge(const std::string& firstTok, const std::string& secondTok)
   if(first < length() && second < length())
   {
     for(size_t i=first+1; i<second; ++i)
-      (*this)[first] += (*this)[i];
-    for(size_t i=first+1; i<second; ++i)
-      remove(first+1);
+      toks[first] += toks[i];
+    ids[first] = pool.intern(toks[first]);
+    indexValid = false;
+    toks.erase(toks.begin()+first+1, toks.begin()+second);
+    ids.erase(ids.begin()+first+1, ids.begin()+second);
     return true;
   }
   return false;
@@ -153,8 +224,11 @@ bool SemiExp::merge(const std::string& firstTok, const std::string& secondTok)
 
 void SemiExp::trimFront()
 {
-  while(toks.size() > 0 && (toks[0] == "\n" || toks[0] == ""))
-    remove(0);
+  size_t n = 0;
+  while(n < toks.size() && (ids[n] == Tok::NewLine || toks[n].empty()))
+    ++n;
+  if(n > 0)
+    removeFront(n);
 }
 //----< make tokens lowercase >--------------------------------
 
@@ -166,7 +240,9 @@ void SemiExp::toLower()
     {
       (*this)[i][j] = tolower((*this)[i][j]);
     }
+    ids[i] = pool.intern(toks[i]);
   }
+  indexValid = false;
 }
 
 //----< test stub >--------------------------------------------
@@ -217,6 +293,10 @@ int main(int argc, char* argv[])
   std::cout << "\n  position of \"two\" is " << pos;
   pos = semi.find("foobar");
   std::cout << "\n  position of \"foobar\" is " << pos;
+  semi.push_back(";");
+  pos = semi.find(Tok::Semicolon);
+  std::cout << "\n  position of Tok::Semicolon is " << pos;
+  std::cout << "\n  id of \"two\" is " << semi.id(1);
   std::cout << "\n\n";
 
   std::cout << "\n  Note that comments and quotes are returned as single tokens\n";
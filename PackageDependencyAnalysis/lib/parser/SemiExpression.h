@@ -2,7 +2,7 @@
 #define SEMIEXPRESSION_H
 /////////////////////////////////////////////////////////////////////
 //  SemiExpression.h - Collects tokens for code analysis           //
-//  ver 2.1                                                        //
+//  ver 2.4                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -25,6 +25,18 @@
   to complete the detection process.  This simplifies the design of code
   analysis tools.
 
+  Each token is interned into a TokenPool owned by the SemiExp, and the
+  collection keeps its id beside its text.  Terminators, find() and the
+  parsing rules compare ids, which are fixed for punctuators and keywords,
+  instead of strings.  Ids follow the tokens changed by merge() and
+  toLower(); a token written through operator[] keeps its old id.
+
+  While tokens are collected, the position of the first token of each
+  reserved id is recorded, so find() of a punctuator or keyword, done by
+  nearly every rule, is one lookup instead of a scan.  Removing the front
+  token, as trimFront() does, shifts the recorded positions; other edits
+  make the next find() index the collection again.
+
   Note that assignment and copying of SemiExp instances is supported, using
   the default operations provided by the C++ language.  Copies and assignments
   result in both source and target SemiExp instances sharing the same toker.
@@ -39,19 +51,39 @@
   std::string tok = se[2] = "a change";     // indexed read and write
   if(se.find("aTok") < se.length())         // search for a token
     std::cout << "found aTok";  
+  if(se.id(0) == Tok::Typedef)              // interned id of a token
+    std::cout << "typedef";
+  size_t pos = se.find(Tok::LeftParen);     // search by id
   se.clear();                               // remove all tokens
+  se.reset();                               // and forget the interned ones, between files
 
   Build Process:
   ==============
   Required files
-    - SemiExpression.h, SemiExpression.cpp, Tokenizer.h, Tokenizer.cpp
+    - SemiExpression.h, SemiExpression.cpp, Tokenizer.h, Tokenizer.cpp,
+      MappedFile.h, MappedFile.cpp, TokenPool.h, TokenPool.cpp
   Build commands (either one)
     - devenv Project1HelpS06.sln
-    - cl /EHsc /DTEST_SEMIEXPRESSION SemiExpression.cpp Tokenizer.cpp \
-         /link setargv.obj
+    - cl /EHsc /DTEST_SEMIEXPRESSION SemiExpression.cpp Tokenizer.cpp MappedFile.cpp \
+         TokenPool.cpp /link setargv.obj
 
   Maintenance History:
   ====================
+  ver 2.6 : 17 Oct 26
+  - added reset(), which also clears the token pool, so a SemiExp used
+    for many files holds the names of one file at a time
+  ver 2.5 : 17 Oct 26
+  - trimFront() and merge() remove their tokens with one erase each,
+    so leading blank lines and long merges cost linear time
+  ver 2.4 : 17 Oct 26
+  - get() records where the first token of each reserved id is, so
+    find() of punctuators and keywords takes constant time
+  ver 2.3 : 17 Oct 26
+  - tokens are interned, with their ids kept beside them, and compared
+    by id in isTerminator(), find(), remove() and trimFront()
+  ver 2.2 : 17 Oct 26
+  - get() reads Token views from the Toker and copies only the tokens
+    it keeps into the collection
   ver 2.1 : 09 Jun 11
   - added support for selecting whether to return newlines (true by default)
   ver 2.0 : 02 Jun 11
@@ -82,6 +114,7 @@
 #include <vector>
 #include "ITokCollection.h"
 #include "tokenizer.h"
+#include "TokenPool.h"
 
 class SemiExp : public ITokCollection
 {
@@ -92,6 +125,8 @@ public:
   size_t length();
   std::string& operator[](int n);
   size_t find(const std::string& tok);
+  TokId id(size_t n);
+  size_t find(TokId id);
   void push_back(const std::string& tok);
   bool remove(const std::string& tok);
   bool remove(size_t i);
@@ -99,6 +134,7 @@ public:
   void toLower();
   void trimFront();
   void clear();
+  void reset();
   std::string show(bool showNewLines=false);
   void verbose(bool v = true);
   void makeCommentSemiExp(bool commentIsSE = true);
@@ -108,7 +144,18 @@ public:
 private:
   Toker* pToker;
   std::vector<std::string> toks;
-  bool isTerminator(std::string tok);
+  std::vector<TokId> ids;  // interned id of each token
+  TokenPool pool;
+  std::vector<size_t> firstPos;  // reserved id -> position of its first token + trimmed
+  std::vector<TokId> indexedIds; // reserved ids with a recorded position
+  size_t trimmed;                // tokens removed from front since indexing
+  bool indexValid;               // false after edits other than front removal
+  void index(TokId id, size_t pos);
+  void resetIndex();
+  void buildIndex();
+  void removeFront(size_t n);
+  bool isTerminator(const Token& tok, TokId id);
+  bool isComment(const char* tok);
   bool Verbose;
   bool commentIsSemiExp;
   bool doReturnNewLines;
@@ -125,10 +172,24 @@ inline void SemiExp::makeCommentSemiExp(bool commentIsSE)
 
 inline void SemiExp::returnNewLines(bool doReturn) { doReturnNewLines = doReturn; }
 
-inline void SemiExp::clear() { toks.clear(); }
+inline void SemiExp::clear()
+{
+  toks.clear();
+  ids.clear();
+  resetIndex();
+}
+
+inline void SemiExp::reset()
+{
+  clear();
+  pool.clear();
+}
 
 inline void SemiExp::push_back(const std::string& tok)
 {
+  TokId id = pool.intern(tok);
+  index(id, ids.size());
+  ids.push_back(id);
   toks.push_back(tok);
 }
 
@@ -23,7 +23,7 @@ Maintanence Information:
 ========================
 Required files:
 ---------------
-none
+TokenPool.h, TokenPool.cpp
 
 Build Process:
 --------------
@@ -38,6 +38,7 @@ Revision History:
 
 #ifdef TEST_STRINGHELPER
 
+#include <iostream>
 #include <string>
 #include "StringHelper.h"
 
@@ -49,6 +50,7 @@ int main(int argc, char* argv[])
 	std::cout<<"\n "<<Helper::isSpace("ass  sd");
 	std::cout<<"\n "<<Helper::tolower('A');
 	std::cout<<"\n "<<Helper::isModifierKeyword("const");
+	std::cout<<"\n "<<Helper::isModifierKeyword(Tok::Const);
 	std::cout<<"\n "<<Helper::isLegalVariable('$');
 	std::cout<<"\n "<<Helper::isLegalVariable("Vertex");
 	std::cout<<"\n "<<Helper::isLegalTemplatedVariable("Vertex<V,E>");
@@ -4,7 +4,7 @@
 //	StringHelper.h - This is a helper class for some string processing	//
 //	work.																//
 //																		//
-//	ver 0.1																//
+//	ver 0.2																//
 //	Language:		Visual C++ 2012, SP1								//
 //	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
 //	Application:	Type Dependency Analysis, CIS687 Pr#1, 2013 Spring	//
@@ -25,6 +25,7 @@ bool res = Helper::isSpace('a');
 bool res = Helper::isSpace("ass  sd");
 char chr = Helper::tolower('A');
 bool res = Helper::isModifierKeyword("const");
+bool res = Helper::isModifierKeyword(Tok::Const);
 bool res = Helper::isLegalVariable('$');
 bool res = Helper::isLegalVariable("Vertex");
 bool res = Helper::isLegalTemplatedVariable("Vertex<V,E>");
@@ -33,7 +34,7 @@ Maintanence Information:
 ========================
 Required files:
 ---------------
-none
+CharClass.h, TokenPool.h, TokenPool.cpp
 
 Build Process:
 --------------
@@ -42,14 +43,17 @@ devenv PackageDependencyAnalysis.sln /rebuild debug
 
 Revision History:
 -----------------
+- ver 0.3 : modifier keywords are tested by reserved token id.
+- ver 0.2 : char tests look up CharClass instead of constructing a locale.
 - ver 0.1 : initial version.
 
 */
 
 #include <algorithm> 
 #include <functional> 
-#include <cctype>
-#include <locale>
+#include <string>
+#include "CharClass.h"
+#include "TokenPool.h"
 
 ///////////////////////////////////////////////////////////////
 // Helper namespace
@@ -57,8 +61,7 @@ namespace Helper {
 
 	// whether current char is a white space
 	static inline bool isSpace(const char & chr) {
-		std::locale loc;
-		return isspace(chr, loc);
+		return CharClass::isSpace(chr);
 	}
 
 	// whether current string contains white space
@@ -75,16 +78,34 @@ namespace Helper {
 	}
 
 	// is modifier like const, final, etc.
+	static inline bool isModifierKeyword(TokId id)
+	{
+		switch (id) {
+		case Tok::Return: case Tok::New: case Tok::Delete: case Tok::Operator:
+		case Tok::Signed: case Tok::Unsigned: case Tok::Const: case Tok::Volatile:
+		case Tok::Struct: case Tok::Enum: case Tok::Friend: case Tok::Class:
+		case Tok::Union: case Tok::Typename: case Tok::Inline: case Tok::Virtual:
+		case Tok::Static: case Tok::Mutable: case Tok::ThreadLocal: case Tok::Register:
+		case Tok::Extern: case Tok::Public: case Tok::Private: case Tok::Protected:
+		case Tok::Case: case Tok::Amp: case Tok::Star: case Tok::StarAmp:
+		case Tok::AmpStar: case Tok::For: case Tok::While: case Tok::Else:
+		case Tok::Continue: case Tok::True: case Tok::False: case Tok::Switch:
+		case Tok::If: case Tok::Catch: case Tok::Try: case Tok::DynamicCast:
+		case Tok::StaticCast:
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	static inline bool isModifierKeyword(const std::string& s)
 	{
-		const static std::string keys="|return|new|delete|operator|signed|unsigned|const|volatile|struct|enum|friend|class|union|typename|inline|virtual|static|mutable|thread_local|register|extern|public|private|protected|case|&|*|*&|&*|for|while|else|continue|true|false|switch|if|catch|try|dynamic_cast|static_cast|";
-		return keys.find("|"+s+"|")!=std::string::npos;
+		return isModifierKeyword(TokenPool::reserved(s));
 	}
 
 	// is one char an acceptable variable character
 	static inline bool isLegalVariable(const char& chr) {
-		std::locale loc;
-		return isalnum(chr,loc) || chr=='_' || chr=='$';
+		return CharClass::isVariable(chr);
 	}
 
 	// is this string a legal variable style
@@ -92,7 +113,7 @@ namespace Helper {
 		bool res=!str.empty();
 		size_t pos=0;
 		if (str[0]=='~') pos++;
-		res = res && isLegalVariable(str[pos]) && !isdigit(str[pos]);
+		res = res && isLegalVariable(str[pos]) && !CharClass::isDigit(str[pos]);
 		while (res && ++pos<str.length()) res = isLegalVariable(str[pos]);
 		return res;
 	}
@@ -102,7 +123,7 @@ namespace Helper {
 		bool res=!str.empty();
 		size_t pos=0;
 		if (str[0]=='~') pos++;
-		res = res && isLegalVariable(str[pos]) && !isdigit(str[pos]);
+		res = res && isLegalVariable(str[pos]) && !CharClass::isDigit(str[pos]);
 		pos++;
 		for (size_t bracket=0;res && pos<str.length();pos++) {
 			if (str[pos]=='<') { // count bracket
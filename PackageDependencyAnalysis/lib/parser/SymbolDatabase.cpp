@@ -0,0 +1,400 @@
+//////////////////////////////////////////////////////////////////////////
+//	SymbolDatabase.cpp - Owns the SymbolTable of every parsed package	//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Package Operations:
+===================
+Implements SymbolDatabase, and tests it
+
+Public Interface:
+=================
+none
+
+Maintanence Information:
+========================
+Required files:
+---------------
+SymbolDatabase.h, SymbolTable.h, SymbolTable.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.7 : analyzeChanged() returns the packages it analyzed.
+- ver 0.6 : added update() and analyzeChanged().
+- ver 0.5 : tables are ordered after parsing, create() takes one lock.
+- ver 0.4 : added clear().
+- ver 0.3 : added include closure.
+- ver 0.2 : added type index.
+- ver 0.1 : initial version.
+
+*/
+#include <algorithm>
+#include "SymbolDatabase.h"
+
+//----< destructor, release all tables >-----------------------------------
+
+SymbolDatabase::~SymbolDatabase() {
+	for (size_t i=0;i<ShardCount;i++)
+		for (auto & e : _shards[i].tables)
+			delete e.second;
+}
+
+//----< release all tables and indices, to fill the database again >-------
+
+void SymbolDatabase::clear() {
+	for (size_t i=0;i<ShardCount;i++) {
+		for (auto & e : _shards[i].tables)
+			delete e.second;
+		_shards[i].tables.clear();
+		_shards[i].created.clear();
+	}
+	_created = 0;
+	_ordered = 0;
+	_order.clear();
+	_typeIndex.clear();
+	_includes.clear();
+	_componentOf.clear();
+	_closures.clear();
+	_unresolved.clear();
+	_changed.clear();
+	_resolve.clear();
+	_stale.clear();
+}
+
+//----< create a table for the package of file f, thread safe >------------
+
+SymbolTable* SymbolDatabase::create(std::string f) {
+	f = SymbolTable::getPackageName(f);
+	Shard& s = shardOf(f);
+	std::lock_guard<std::mutex> lock(s.lock);
+	Table::iterator it = s.tables.find(f);
+	if (it != s.tables.end())
+		return it->second;
+	SymbolTable* pTable = new SymbolTable(f, this);
+	s.tables[f] = pTable;
+	s.created.push_back(std::make_pair(_created++, entry(f, pTable)));
+	return pTable;
+}
+
+//----< put the tables created since last time in creation order, not while parsing >
+
+void SymbolDatabase::merge() {
+	std::vector<std::pair<size_t, entry>> created;
+	for (size_t i=0;i<ShardCount;i++) {
+		created.insert(created.end(), _shards[i].created.begin(), _shards[i].created.end());
+		_shards[i].created.clear();
+	}
+	std::sort(created.begin(), created.end(),
+		[](const std::pair<size_t, entry>& a, const std::pair<size_t, entry>& b) { return a.first < b.first; });
+	for (auto & c : created) {
+		c.second.second->id() = _order.size();
+		_order.push_back(c.second);
+	}
+	_ordered += created.size();
+}
+
+//----< return the table of package, 0 when it is not registered >---------
+
+SymbolTable* SymbolDatabase::find(const std::string& package) {
+	Shard& s = shardOf(package);
+	std::lock_guard<std::mutex> lock(s.lock);
+	Table::iterator it = s.tables.find(package);
+	return (it != s.tables.end()) ? it->second : 0;
+}
+
+//----< analyze the file dependency relationship of all tables >-----------
+
+void SymbolDatabase::analyzeAll() {
+	buildTypeIndex();
+	buildIncludeClosure();
+	for (iterator it=begin();it!=end();it++)
+		it->second->analyze();
+}
+
+//----< index every defined type by its qualified name >-------------------
+
+void SymbolDatabase::buildTypeIndex() {
+	_typeIndex.clear();
+	for (iterator it=begin();it!=end();it++)
+		indexTypes(it->second);
+}
+
+//----< add the types of table to the type index >------------------------
+
+void SymbolDatabase::indexTypes(SymbolTable* pTable) {
+	for (const std::string & type : pTable->types())
+		_typeIndex[type].push_back(pTable);
+}
+
+//----< take the types of table out of the type index >--------------------
+
+void SymbolDatabase::unindexTypes(SymbolTable* pTable) {
+	for (const std::string & type : pTable->types()) {
+		std::unordered_map<std::string, definers>::iterator it = _typeIndex.find(type);
+		if (it == _typeIndex.end()) continue;
+		it->second.erase(std::remove(it->second.begin(), it->second.end(), pTable), it->second.end());
+		if (it->second.empty()) _typeIndex.erase(it);
+	}
+}
+
+//----< build direct includes and transitive include closure of all tables >
+
+void SymbolDatabase::buildIncludeClosure() {
+	_includes.assign(size(), idArray());
+	_unresolved.clear();
+	for (size_t i=0;i<_includes.size();i++)
+		resolveIncludes(i);
+	closeIncludes();
+}
+
+//----< resolve included packages into table ids, skipping itself and packages not parsed >
+
+void SymbolDatabase::resolveIncludes(size_t id) {
+	SymbolTable* pIncluder = _order[id].second;
+	const SymbolTable::strArray& inc = pIncluder->fileInc();
+	_includes[id].clear();
+	for (size_t k=1;k<inc.size();k++) {
+		SymbolTable* pTable = find(inc[k]);
+		if (pTable) _includes[id].push_back(pTable->id());
+		else _unresolved[inc[k]].insert(pIncluder);	// resolved again if the package turns up
+	}
+}
+
+//----< strong components of the include graph and their closures >-------
+
+void SymbolDatabase::closeIncludes() {
+	const size_t none = (size_t)-1, n = _includes.size();
+	// Tarjan's algorithm with an explicit stack, each component is closed
+	// after all components it includes
+	std::vector<size_t> index(n, none), lowlink(n, 0), mark(n, none);
+	std::vector<bool> onStack(n, false);
+	idArray stack, members;
+	std::vector<std::pair<size_t, size_t>> path;	// vertex, next include to visit
+	_componentOf.assign(n, none);
+	_closures.clear();
+	size_t counter = 0;
+	for (size_t root=0;root<n;root++) {
+		if (index[root] != none) continue;
+		index[root] = lowlink[root] = counter++;
+		stack.push_back(root);
+		onStack[root] = true;
+		path.push_back(std::make_pair(root, (size_t)0));
+		while (!path.empty()) {
+			size_t v = path.back().first;
+			if (path.back().second < _includes[v].size()) {
+				size_t w = _includes[v][path.back().second++];
+				if (index[w] == none) {	// descend
+					index[w] = lowlink[w] = counter++;
+					stack.push_back(w);
+					onStack[w] = true;
+					path.push_back(std::make_pair(w, (size_t)0));
+				}
+				else if (onStack[w] && index[w] < lowlink[v])
+					lowlink[v] = index[w];
+				continue;
+			}
+			path.pop_back();
+			if (!path.empty() && lowlink[v] < lowlink[path.back().first])
+				lowlink[path.back().first] = lowlink[v];
+			if (lowlink[v] == index[v]) {	// v is the root of a component
+				members.clear();
+				size_t w;
+				do {
+					w = stack.back();
+					stack.pop_back();
+					onStack[w] = false;
+					_componentOf[w] = _closures.size();
+					members.push_back(w);
+				} while (w != v);
+				closeComponent(members, mark);
+			}
+		}
+	}
+}
+
+//----< closure of one component: its members and the closures it includes >
+
+void SymbolDatabase::closeComponent(const idArray& members, std::vector<size_t>& mark) {
+	size_t c = _closures.size();
+	idArray closure(members);
+	mark[c] = c;
+	for (size_t m : members)
+		for (size_t w : _includes[m]) {
+			size_t d = _componentOf[w];
+			if (mark[d] == c) continue;	// already merged, or this component
+			mark[d] = c;
+			closure.insert(closure.end(), _closures[d].begin(), _closures[d].end());
+		}
+	std::sort(closure.begin(), closure.end());
+	closure.erase(std::unique(closure.begin(), closure.end()), closure.end());
+	_closures.push_back(closure);
+}
+
+//----< add the tables whose closure holds one of the sorted ids >---------
+
+void SymbolDatabase::markIncluders(const idArray& ids, std::unordered_set<SymbolTable*>& tables) {
+	if (ids.empty()) return;
+	std::vector<bool> isMarked(_closures.size(), false);
+	for (size_t c=0;c<_closures.size();c++)
+		for (size_t k=0;k<ids.size() && !isMarked[c];k++)
+			isMarked[c] = std::binary_search(_closures[c].begin(), _closures[c].end(), ids[k]);
+	for (size_t i=0;i<_componentOf.size();i++)
+		if (isMarked[_componentOf[i]]) tables.insert(_order[i].second);
+}
+
+//----< clear changed tables and release removed ones, after an analysis >--
+
+void SymbolDatabase::update(const std::vector<std::string>& changed, const std::vector<std::string>& removed) {
+	order();
+	idArray ids;
+	std::vector<SymbolTable*> gone;
+	for (size_t i=0;i<changed.size();i++) {
+		SymbolTable* pTable = find(changed[i]);
+		if (pTable) {
+			ids.push_back(pTable->id());
+			_changed.push_back(pTable);
+		}
+		// includes of the package may resolve now, if it is new
+		std::unordered_map<std::string, std::unordered_set<SymbolTable*>>::iterator it = _unresolved.find(changed[i]);
+		if (it != _unresolved.end()) {
+			_resolve.insert(it->second.begin(), it->second.end());
+			_unresolved.erase(it);
+		}
+	}
+	for (size_t i=0;i<removed.size();i++) {
+		SymbolTable* pTable = find(removed[i]);
+		if (pTable) {
+			ids.push_back(pTable->id());
+			gone.push_back(pTable);
+		}
+	}
+	// tables which include a changed or removed table may find their types elsewhere now
+	std::sort(ids.begin(), ids.end());
+	markIncluders(ids, _stale);
+	for (size_t i=0;i<_changed.size();i++) {
+		unindexTypes(_changed[i]);
+		_changed[i]->clear();
+		_resolve.insert(_changed[i]);
+	}
+	release(gone);
+}
+
+//----< release tables, renumbering the others >---------------------------
+
+void SymbolDatabase::release(const std::vector<SymbolTable*>& tables) {
+	if (tables.empty()) return;
+	const size_t none = (size_t)-1;
+	std::unordered_set<SymbolTable*> isGone(tables.begin(), tables.end());
+	std::vector<size_t> newId(_order.size(), none);
+	std::vector<entry> kept;
+	for (size_t i=0;i<_order.size();i++)
+		if (!isGone.count(_order[i].second)) {
+			newId[i] = kept.size();
+			kept.push_back(_order[i]);
+		}
+	// renumber the resolved includes, a table which included a released one resolves its includes again
+	std::vector<idArray> includes;
+	for (size_t i=0;i<_includes.size();i++) {
+		if (newId[i] == none) continue;
+		includes.push_back(idArray());
+		for (size_t w : _includes[i])
+			if (newId[w] != none) includes.back().push_back(newId[w]);
+			else _resolve.insert(_order[i].second);
+	}
+	_includes.swap(includes);
+	_componentOf.clear();	// closed again by analyzeChanged()
+	_closures.clear();
+	for (SymbolTable* pTable : tables) {
+		unindexTypes(pTable);
+		_stale.erase(pTable);
+		_resolve.erase(pTable);
+		for (auto & u : _unresolved)
+			u.second.erase(pTable);
+		Shard& s = shardOf(pTable->name());
+		s.tables.erase(pTable->name());
+	}
+	_order.swap(kept);
+	for (size_t i=0;i<_order.size();i++)
+		_order[i].second->id() = i;
+	for (SymbolTable* pTable : tables)
+		delete pTable;
+}
+
+//----< analyze again the tables changed since update() and their includers >
+
+std::vector<std::string> SymbolDatabase::analyzeChanged() {
+	order();
+	// tables created since the last analysis are new packages
+	for (size_t i=_includes.size();i<_order.size();i++) {
+		_changed.push_back(_order[i].second);
+		_resolve.insert(_order[i].second);
+	}
+	_includes.resize(_order.size());
+	for (SymbolTable* pTable : _changed)
+		indexTypes(pTable);
+	for (SymbolTable* pTable : _resolve)
+		resolveIncludes(pTable->id());
+	closeIncludes();
+	// with the new closures, the tables which include a changed one
+	idArray ids;
+	for (SymbolTable* pTable : _changed)
+		ids.push_back(pTable->id());
+	std::sort(ids.begin(), ids.end());
+	markIncluders(ids, _stale);
+	std::vector<std::string> analyzed;
+	for (SymbolTable* pTable : _stale) {
+		pTable->analyze();
+		analyzed.push_back(pTable->name());
+	}
+	_changed.clear();
+	_resolve.clear();
+	_stale.clear();
+	return analyzed;
+}
+
+#ifdef TEST_SYMBOLDATABASE
+
+#include <iostream>
+
+int main()
+{
+	std::cout << "\n  Testing SymbolDatabase\n ";
+	SymbolDatabase db;
+	SymbolTable* pA = db.create("./A.cpp");
+	SymbolTable* pB = db.create("./B.h");
+	pA->includeFile("B.h");
+	pA->includeFile("iostream");
+	pA->declareType("B", "::A");
+	pB->defineType("::B");
+	std::cout << "\n same table for a.h and a.cpp: " << (db.create("./a.h") == pA);
+	db.analyzeAll();
+	for (SymbolDatabase::iterator it=db.begin(); it!=db.end(); it++)
+		for (const auto & f : it->second->files())
+			std::cout << "\n package " << it->first << " uses " << f;
+	std::cout << "\n a includes " << db.includesOf(pA->id()).size() << " parsed package";
+	// B is gone, a now includes a new package C which defines its type
+	std::vector<std::string> changed, removed(1, "b");
+	changed.push_back("a");
+	changed.push_back("c");
+	db.update(changed, removed);
+	pA->includeFile("C.h");
+	pA->declareType("B", "::A");
+	db.create("./C.h")->defineType("::B");
+	db.analyzeChanged();
+	for (const auto & f : pA->files())
+		std::cout << "\n after the change, package a uses " << f;
+	std::cout << "\n tables: " << db.size();
+	std::cout << "\n\n";
+}
+#endif
@@ -0,0 +1,221 @@
+#ifndef SYMBOLDATABASE_H
+#define SYMBOLDATABASE_H
+
+//////////////////////////////////////////////////////////////////////////
+//	SymbolDatabase.h - Owns the SymbolTable of every parsed package		//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A SymbolDatabase holds the SymbolTable of every package of one analysis.
+It replaces the static registry that used to live in SymbolTable, so that
+several analyses can live in one process, each with its own database.
+
+Tables are created by the parsers through the Repository, possibly from
+many threads at once.  The tables are spread over a number of shards, each
+guarded by its own lock, so that parsing threads seldom wait for each other.
+A creation only takes a number from an atomic counter and notes it in its
+shard; the tables are put in creation order and given their ids in one
+serial pass, the first time the database is read after parsing.
+Iterating the database visits the tables in the order they were created.
+
+Before analyzing, the database indexes every defined type by its fully
+qualified name, so a SymbolTable resolves a declared type with one hash
+probe per candidate scope instead of scanning the types of every included
+file.
+
+It also computes the transitive include closure of every table once, over
+the whole include graph: include cycles are condensed into strong
+components with Tarjan's algorithm, then closures are merged component by
+component in topological order and kept as sorted arrays of table ids.
+Tables of one cycle share one closure.  Included packages which are not
+parsed (system headers etc.) are left out of both.
+
+When files change in a long running analysis, only their packages are
+parsed again.  update() clears the tables of the changed packages and
+releases those of packages which are gone; once the files of the changed
+packages are parsed into their tables again, analyzeChanged() puts their
+types back in the type index, resolves again the includes which may have
+changed, closes the include graph again, and analyzes again only the
+tables whose closure held a changed table, before or after the change,
+returning their packages.  The other tables keep what they found.
+
+Public Interface:
+=================
+SymbolDatabase db;
+SymbolTable* pSymbol = db.create(filePath);
+SymbolTable* pSymbol = db.find(packageName);	// 0 when not registered
+db.buildTypeIndex();	// done by analyzeAll()
+db.buildIncludeClosure();	// done by analyzeAll()
+const SymbolDatabase::idArray& inc = db.includesOf(pSymbol->id());
+const SymbolDatabase::idArray& all = db.closureOf(pSymbol->id());
+SymbolTable* pSymbol = db[id];
+const SymbolDatabase::definers* pList = db.findDefiners("::GraphLib::Graph<,>");
+db.analyzeAll();
+db.update(changedPackages, removedPackages);	// then parse the files of changedPackages
+std::vector<std::string> analyzed = db.analyzeChanged();	// packages analyzed again
+for (SymbolDatabase::iterator it=db.begin(); it!=db.end(); it++)
+	std::cout << it->first;	// it->second is the SymbolTable
+size_t n = db.size();
+db.clear();	// release all tables, not while parsing
+
+Maintanence Information:
+========================
+Required files:
+---------------
+SymbolTable.h, SymbolTable.cpp, SymbolDatabase.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.7 analyzeChanged() returns the packages it analyzed
+- ver 0.6 added update() and analyzeChanged()
+- ver 0.5 creation order is merged from the shards after parsing
+- ver 0.4 added clear()
+- ver 0.3 added include closure
+- ver 0.2 added type index
+- ver 0.1 first version
+
+*/
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include "SymbolTable.h"
+
+///////////////////////////////////////////////////////////////
+// SymbolDatabase class
+class SymbolDatabase {
+public:
+	typedef std::pair<std::string, SymbolTable*> entry;	// package name, its table
+	typedef std::vector<entry>::iterator iterator;
+	typedef std::vector<SymbolTable*> definers;	// tables which define one type
+	typedef std::vector<size_t> idArray;	// table ids
+
+	SymbolDatabase() : _created(0), _ordered(0) {}
+	~SymbolDatabase();
+
+	// create a SymbolTable for the file's package, or return the existing one
+	SymbolTable* create(std::string f);
+
+	// return the table of a package, 0 if it is not registered
+	SymbolTable* find(const std::string& package);
+
+	// release all tables and indices, to fill the database again
+	void clear();
+
+	// analyze the file dependency relationship of every table
+	void analyzeAll();
+
+	// clear the tables of changed packages and release those of removed packages,
+	// after an analysis; parse the files of the changed packages, then call analyzeChanged()
+	void update(const std::vector<std::string>& changed, const std::vector<std::string>& removed);
+
+	// analyze the tables changed since update() again, with the tables which include them,
+	// return the packages analyzed
+	std::vector<std::string> analyzeChanged();
+
+	// index all defined types of all tables by their qualified name
+	void buildTypeIndex();
+
+	// compute included tables and the transitive include closure of every table
+	void buildIncludeClosure();
+
+	// return ids of the tables directly included by table id, in include order
+	const idArray& includesOf(size_t id) const { return _includes[id]; }
+
+	// return sorted ids of all tables included by table id, directly or not, itself included
+	const idArray& closureOf(size_t id) const { return _closures[_componentOf[id]]; }
+
+	// return the table with specific id
+	SymbolTable* operator[](size_t id) { order(); return _order[id].second; }
+
+	// return the tables defining a qualified type name, 0 if there is none
+	const definers* findDefiners(const std::string& type) const {
+		std::unordered_map<std::string, definers>::const_iterator it = _typeIndex.find(type);
+		return (it != _typeIndex.end()) ? &it->second : 0;
+	}
+
+	// return first table, in creation order
+	iterator begin() { order(); return _order.begin(); }
+
+	// return one past last table
+	iterator end() { order(); return _order.end(); }
+
+	// return number of tables
+	size_t size() { order(); return _order.size(); }
+
+private:
+	static const size_t ShardCount = 16;
+	typedef std::unordered_map<std::string, SymbolTable*> Table;
+
+	///////////////////////////////////////////////////////////////
+	// one part of the tables, with its own lock
+	struct Shard {
+		std::mutex lock;
+		Table tables;
+		std::vector<std::pair<size_t, entry>> created;	// tables not yet ordered, with their creation number
+	};
+
+	Shard _shards[ShardCount];
+	std::atomic<size_t> _created;	// number of tables created
+	size_t _ordered;	// number of created tables put in _order
+	std::vector<entry> _order;	// all tables, in creation order
+	std::unordered_map<std::string, definers> _typeIndex;	// qualified type name -> tables defining it
+	std::vector<idArray> _includes;	// table id -> directly included table ids
+	std::vector<size_t> _componentOf;	// table id -> include cycle (strong component) index
+	std::vector<idArray> _closures;	// strong component index -> sorted closure
+	std::unordered_map<std::string, std::unordered_set<SymbolTable*>> _unresolved;	// included package without a table -> tables including it
+	std::vector<SymbolTable*> _changed;	// tables cleared by update()
+	std::unordered_set<SymbolTable*> _resolve;	// tables whose includes are resolved again by analyzeChanged()
+	std::unordered_set<SymbolTable*> _stale;	// tables analyzed again by analyzeChanged()
+
+	Shard& shardOf(const std::string& package) {
+		return _shards[std::hash<std::string>()(package) % ShardCount];
+	}
+
+	// append the tables created since the last call to _order, giving them their ids
+	void order() {
+		if (_ordered != _created) merge();
+	}
+	void merge();
+
+	// add the types of table to the type index, or take them out
+	void indexTypes(SymbolTable* pTable);
+	void unindexTypes(SymbolTable* pTable);
+
+	// resolve the included packages of table id into table ids
+	void resolveIncludes(size_t id);
+
+	// condense include cycles and compute the closure of every strong component
+	void closeIncludes();
+
+	// close a strong component of the include graph, merging the closures it includes
+	void closeComponent(const idArray& members, std::vector<size_t>& mark);
+
+	// add to tables every table whose closure holds one of the sorted ids
+	void markIncluders(const idArray& ids, std::unordered_set<SymbolTable*>& tables);
+
+	// release tables, renumbering the others
+	void release(const std::vector<SymbolTable*>& tables);
+
+	// prohibit copies and assignments
+	SymbolDatabase(const SymbolDatabase&);
+	SymbolDatabase& operator=(const SymbolDatabase&);
+};
+
+#endif
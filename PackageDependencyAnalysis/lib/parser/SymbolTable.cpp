@@ -22,7 +22,7 @@ Maintanence Information:
 ========================
 Required files:
 ---------------
-SymbolTable.h
+SymbolTable.h, SymbolDatabase.h
 
 Build Process:
 --------------
@@ -31,14 +31,84 @@ devenv PackageDependencyAnalysis.sln /rebuild debug
 
 Revision History:
 -----------------
+- ver 0.5 : indirect includes are ranked breadth first, as cleanFileInc() expanded them.
+- ver 0.4 : included packages are ranked from the closure built by SymbolDatabase.
+- ver 0.3 : declared types are resolved with one index probe per candidate scope.
+- ver 0.2 : dependency analysis moved here, looks up tables through SymbolDatabase.
 - ver 0.1 : initial version.
 
 */
 #include "SymbolTable.h"
+#include "SymbolDatabase.h"
 
-// static member must be defined!!
-SymbolTable::Table SymbolTable::_t;
-SymbolTable::strSet SymbolTable::_nonexistFileList;
+//----< search file from "included file" for a specific type >-----------
+
+void SymbolTable::searchFile(const declaredType& type) {
+	// the type is used from the best ranked included file which defines it in any candidate
+	// scope, files which are already used (except itself) are skipped
+	size_t best = (size_t)-1;
+	SymbolTable* pBest = 0;
+	std::string name = type.first, scope = type.second;
+	//std::cout<<"\n matching type "<< name<<" "<<scope;
+	matchType(scope,name,best,pBest);
+	while (!scope.empty()) {
+		// reduce scope by one namespace
+		size_t pos = scope.find_last_of("::");
+		if (pos != std::string::npos) scope.erase(pos); else scope="";
+		matchType(scope,name,best,pBest);
+	}
+	// well, no scope left, now try "using namespace"
+	for (auto ns=_namespaceUsing.begin();ns!=_namespaceUsing.end();ns++)
+		matchType(*ns,name,best,pBest);
+	if (pBest)
+		addFileUsed(pBest->name());	// cheer! found!
+}
+
+//----< rank the include closure in the order the includes expand >------
+// itself first, then its direct includes in order, then the includes of
+// each of those in turn, breadth first, every table where it is met first
+
+void SymbolTable::rankIncludes() {
+	const SymbolDatabase::idArray& closure = _db->closureOf(_id);
+	_rank.assign(closure.size(), (size_t)-1);
+	SymbolDatabase::idArray expanded(1, _id);	// tables in expansion order
+	_rank[std::lower_bound(closure.begin(), closure.end(), _id)-closure.begin()] = 0;
+	for (size_t i=0;i<expanded.size();i++) {
+		const SymbolDatabase::idArray& direct = _db->includesOf(expanded[i]);
+		for (size_t k=0;k<direct.size();k++) {
+			size_t at = std::lower_bound(closure.begin(), closure.end(), direct[k])-closure.begin();
+			if (_rank[at] != (size_t)-1) continue;	// met before
+			_rank[at] = expanded.size();
+			expanded.push_back(direct[k]);
+		}
+	}
+}
+
+//----< rank of an included package, (size_t)-1 when not included >-----
+
+size_t SymbolTable::includeRank(size_t id) {
+	const SymbolDatabase::idArray& closure = _db->closureOf(_id);
+	SymbolDatabase::idArray::const_iterator it = std::lower_bound(closure.begin(), closure.end(), id);
+	if (it == closure.end() || *it != id) return (size_t)-1;
+	return _rank[it-closure.begin()];
+}
+
+//----< keep the best ranked included package which defines ns::name >---
+
+void SymbolTable::matchType(const std::string & ns, const std::string & name, size_t & best, SymbolTable*& pBest) {
+	// reminder : if ns is ended with "::", means this type is declared in a temporary/private scope
+	const SymbolDatabase::definers* pDefiners = _db->findDefiners(ns+"::"+name);
+	if (!pDefiners) return;
+	for (SymbolTable* pTable : *pDefiners) {
+		size_t rank = includeRank(pTable->id());
+		if (rank >= best)
+			continue;	// not included, or a better ranked file defines it
+		if (rank > 0 && _fileUsed.find(pTable->name()) != _fileUsed.end())
+			continue;	// already used
+		best = rank;
+		pBest = pTable;
+	}
+}
 
 #ifdef TEST_SYMBOLTABLE
 
@@ -47,7 +117,8 @@ SymbolTable::strSet SymbolTable::_nonexistFileList;
 
 int main()
 {
-	SymbolTable* pSymbol = SymbolTable::create("Graph.h");
+	SymbolDatabase db;
+	SymbolTable* pSymbol = db.create("Graph.h");
 
 	symbol.defineType("GraphLib::Graph<V,E>");
 	symbol.declareType("GraphLib::Graph<V,E>");
@@ -55,7 +126,6 @@ int main()
 	symbol.includeFile("XmlReader.h");
 	symbol.useNamespace("::GraphLib");
 	symbol.analyze();
-	symbol.cleanFileInc();
 
 	std::vector<std::string> list1 = symbol.fileInc();
 	for (auto & str : list1)
@@ -69,7 +139,7 @@ int main()
 	std::string name = SymbolTable::getPackageName("./SymbolTable.h");
 	std::cout<<"\n package name "<<*it;
 
-	SymbolTable::analyzeAll();
+	db.analyzeAll();
 
 	std::unordered_set<std::string> list2 = symbol.files();
 	for (auto it=list2.begin();it!=list2.end();it++)
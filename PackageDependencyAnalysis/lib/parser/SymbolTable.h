@@ -22,36 +22,41 @@ it to this symbol table, so that we know where the type is defined.
 When analyzing the file dependency, you should notice that this class will only
 analyze the included file instead of all file set.
 
-should ALWAYS use SymbolTable::create() to declare a new intance of SymbolTable,
-so that the SymbolTable instance will be added into SymbolTable set
+should ALWAYS use SymbolDatabase::create() to declare a new intance of SymbolTable,
+so that the SymbolTable instance will be added into the database which owns it.
+Each SymbolTable keeps a pointer to its database, which it uses to look up the
+tables of its included files when analyzing.
 
 Public Interface:
 =================
-SymbolTable symbol(packageName);
+SymbolTable symbol(packageName, pDatabase);
 or
-SymbolTable* pSymbol = SymbolTable::create(packageName);
+SymbolTable* pSymbol = database.create(packageName);
 
 symbol.defineType(typeName);
 symbol.declareType(typeName);
 symbol.declareType(typeName, nameScope);
 symbol.includeFile(packageName);
 symbol.useNamespace(nameSpace);
-symbol.analyze();
-symbol.cleanFileInc();
+symbol.record(&facts);	// also note what is added to facts, 0 to stop
+symbol.replay(facts);	// add what a file added before, e.g. from AnalysisCache
+symbol.analyze();	// after the database has built its indices
+symbol.clear();	// forget all facts, to add them again
+size_t& id = symbol.id();
 
 std::vector<std::string> list = symbol.fileInc();
 std::unordered_set<std::string> list = symbol.files();
 std::unordered_set<std::string> list = symbol.types();
+std::string package = symbol.name();
 
 std::string name = SymbolTable::formatTypeName(typeName);
 std::string name = SymbolTable::getPackageName(filePath);
-SymbolTable::analyzeAll();
 
 Maintanence Information:
 ========================
 Required files:
 ---------------
-StringHelper.h
+StringHelper.h, SymbolDatabase.h, SymbolTable.cpp
 
 Build Process:
 --------------
@@ -60,18 +65,43 @@ devenv PackageDependencyAnalysis.sln /rebuild debug
 
 Revision History:
 -----------------
+- ver 0.7 indirect includes are ranked breadth first, as the include list was expanded
+  before ver 0.4, instead of by table id
+- ver 0.6 added clear(), analyze() can be called again
+- ver 0.5 added FileFacts, record() and replay()
+- ver 0.4 include closure is precomputed by SymbolDatabase, cleanFileInc() removed
+- ver 0.3 declared types are resolved through the type index of SymbolDatabase
+- ver 0.2 the tables are owned by a SymbolDatabase instance instead of a static registry
 - ver 0.1 first version
 
 */
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 #include <algorithm>
 #include <string>
-#include <locale>
 #include <iostream>
 #include "StringHelper.h"
 
+class SymbolDatabase;
+
+///////////////////////////////////////////////////////////////
+// what one file adds to its SymbolTable, the arguments of each call in order
+struct FileFacts {
+	std::vector<std::string> defined;	// defineType()
+	std::vector<std::pair<std::string, std::string>> declared;	// declareType(), (typename, declare scope)
+	std::vector<std::string> namespaces;	// useNamespace()
+	std::vector<std::string> included;	// includeFile()
+
+	void clear() {
+		defined.clear();
+		declared.clear();
+		namespaces.clear();
+		included.clear();
+	}
+};
+
 ///////////////////////////////////////////////////////////////
 // An extension to std namespace
 namespace std {
@@ -89,20 +119,19 @@ namespace std {
 // SymbolTable class
 class SymbolTable {
 public:
-	typedef std::unordered_map<std::string, SymbolTable*> Table;
 	typedef std::vector<std::string> strArray;
 	typedef std::unordered_set<std::string> strSet;
 	typedef std::pair<std::string, std::string> declaredType;
-	typedef Table::iterator iterator;
 
-	// each symbol table should be binded to one file
-	SymbolTable(std::string file) : _file(file) {
+	// each symbol table should be binded to one file, and belongs to one database
+	SymbolTable(std::string file, SymbolDatabase* db) : _file(file), _db(db), _id(0), _pFacts(0) {
 		// the following two will not be included in the graph, just for convenient that their index are zero
 		_fileIncluded.push_back(file);	// always put itself as "included"
 	}
 
 	// add the type as it is defined in current file
 	void defineType(std::string t) {
+		if (_pFacts) _pFacts->defined.push_back(t);
 		t = formatTypeName(t);
 		//std::cout<<"\n type defined "<< t;
 		if (t.empty() || _typeDefined.find(t) != _typeDefined.end())
@@ -112,6 +141,7 @@ public:
 
 	// add the type as its instance is declared in current file
 	void declareType(declaredType t) {
+		if (_pFacts) _pFacts->declared.push_back(t);
 		t.first = formatTypeName(t.first);
 		//std::cout<<"\n type declared "<<t.first<<" "<<t.second;
 		if (t.first.empty() || _typeDeclared.find(t) != _typeDeclared.end())
@@ -126,6 +156,7 @@ public:
 
 	// add "using namespace"
 	void useNamespace(std::string ns) {
+		if (_pFacts) _pFacts->namespaces.push_back(ns);
 		ns = formatTypeName(ns);
 		if (ns.empty() || _namespaceUsing.find(ns) != _namespaceUsing.end())
 			return;
@@ -138,6 +169,7 @@ public:
 		// we need to extract the file name, eliminate the file path
 		// there is a BUG that I don't distinguish packages which have same name but different path
 		// but I don't intend to fix it at all, as normally people don't do that, right?
+		if (_pFacts) _pFacts->included.push_back(f);
 		f = getPackageName(f);
 		//std::cout<<"\n include file [ "<<f<<" ]";
 		if (f.empty() || f==_file || std::find(_fileIncluded.begin(), _fileIncluded.end(),f) != _fileIncluded.end())
@@ -145,6 +177,19 @@ public:
 		_fileIncluded.push_back(f);
 	}
 
+	// note the arguments of the calls above in facts too, until record(0)
+	void record(FileFacts* pFacts) {
+		_pFacts = pFacts;
+	}
+
+	// repeat the calls a file made, as noted by record()
+	void replay(const FileFacts& facts) {
+		for (const auto & t : facts.defined) defineType(t);
+		for (const auto & t : facts.declared) declareType(t);
+		for (const auto & ns : facts.namespaces) useNamespace(ns);
+		for (const auto & f : facts.included) includeFile(f);
+	}
+
 	// extract package name, delete file extension and folder path
 	static std::string getPackageName(std::string f) {
 		int pos1 = f.find_last_of('/'), pos2 = f.find_last_of('\\');
@@ -159,66 +204,58 @@ public:
 		return f.substr(pos, pos2);
 	}
 
-	// analyze current file's dependency
+	// analyze current file's dependency, the type index and include closure of the database must be built
 	void analyze() {
-		cleanFileInc();
 		//std::cout<<"\n file "<<_file;
+		_fileUsed.clear();	// from an earlier analysis
+		rankIncludes();
 		// traverse all type declared
 		for (const auto & type : _typeDeclared)
 			searchFile(type);
+		std::vector<size_t>().swap(_rank);	// only needed while analyzing
 	}
 
-	// clean included files for current SymbolTable instance
-	void cleanFileInc() {
-		// skip the first file (i=0), which is itself
-		for (size_t i=1;i<_fileIncluded.size();) {
-			if (_t.find(_fileIncluded[i])==_t.end()) {
-				_nonexistFileList.insert(_fileIncluded[i]);
-				_fileIncluded.erase(_fileIncluded.begin()+i);	// not registered, remove it from file include list
-			}
-			else {
-				SymbolTable* s = _t[_fileIncluded[i]];
-				strArray fList = s->fileInc();
-				// expanding the list, include the files which header files included
-				for (std::string & f : fList) {
-					if (_nonexistFileList.find(f)==_nonexistFileList.end())
-						includeFile(f);
-				}
-				i++;
-			}
-		}
+	// forget all facts, when the files of the package are parsed again
+	void clear() {
+		_typeDefined.clear();
+		_typeDeclared.clear();
+		_namespaceUsing.clear();
+		_fileIncluded.assign(1, _file);
+		_fileUsed.clear();
 	}
 
-	// return included files
-	strArray fileInc() {
+	// return directly included files, the first one is itself
+	const strArray& fileInc() const {
 		return _fileIncluded;
 	}
 
 	// return file list which depend on current file
-	strSet files() {
+	const strSet& files() const {
 		return _fileUsed;
 	}
 
 	// return type list which is defined in current file
-	strSet types() {
+	const strSet& types() const {
 		return _typeDefined;
 	}
 
-	// analyze the file dependency relationship based on SymbolTable set.
-	static void analyzeAll() {
-		// analyze each file
-		for (iterator it=_t.begin();it!=_t.end();it++)
-			it->second->analyze();
+	// return the package name of current file
+	const std::string& name() const {
+		return _file;
+	}
+
+	// set and read the index of this table in its database
+	size_t& id() {
+		return _id;
 	}
 
 	// mainly this function will format a template class name into <> or <,>, and delete the whitespace
 	static std::string formatTypeName(std::string t) {
 		size_t pos = t.find('<'), bracket=0;
 		if (pos==std::string::npos) return t;
-		std::locale loc;
 		while (pos<t.length()) {
 			(t[pos]=='<') ? bracket++ : (t[pos]=='>') ? bracket-- : 0;
-			if (!(bracket==1 && (t[pos]==',' || t[pos]=='<') || bracket==0) || std::isspace(t[pos],loc))
+			if (!(bracket==1 && (t[pos]==',' || t[pos]=='<') || bracket==0) || Helper::isSpace(t[pos]))
 				t.erase(pos,1);
 			else
 				pos++;
@@ -234,36 +271,17 @@ public:
 		return t;
 	}
 
-	// return all SymbolTable instances' first iterator
-	static iterator begin() {
-		return _t.begin();
-	}
-	
-	// return all SymbolTable instances' last iterator
-	static iterator end() {
-		return _t.end();
-	}
-	
-	// return number of SymbolTable instances
-	static size_t size() {
-		return _t.size();
-	}
-	
-	// create a SymbolTable instance and add it to global static set
-	static SymbolTable* create(std::string f) {
-		f = getPackageName(f);
-		return (_t.find(f) != _t.end()) ? _t[f] : _t[f] = new SymbolTable(f);
-	}
-
 private:
-	static Table _t;	// the collection of all files
 	strSet _typeDefined;	// the types which are defined in current file
 	std::unordered_set<declaredType> _typeDeclared;	// the types which are declard in current file, (typename, declare scope)
 	strSet _namespaceUsing;	// the namespaces current file are using
 	std::string _file;	// current file
 	strArray _fileIncluded;	// the files included in current file
 	strSet _fileUsed;	// record which files are actually used by current file
-	static strSet _nonexistFileList;	// record file which doesn't exist, avoiding system lib header file being added again and again
+	SymbolDatabase* _db;	// the database this table belongs to
+	size_t _id;	// index in the database
+	std::vector<size_t> _rank;	// include rank of each table of the closure, in closure order, while analyzing
+	FileFacts* _pFacts;	// where calls are noted, 0 when not recording
 
 	// add files(packages) which are used
 	void addFileUsed(std::string f) {
@@ -274,41 +292,17 @@ private:
 		_fileUsed.insert(f);
 	}
 
-	// return true when a type is found
-	bool isTypeFound(const std::string & f, strSet& types, const std::string & ns, const std::string name) {
-		// reminder : if ns is ended with "::", means this type is declared in a temporary/private scope
-		std::string t = ns+"::"+name;
-		if (types.find(t)!=types.end()) {
-			addFileUsed(f);	// cheer! found!
-			//std::cout<<"\n f "<<_file<<" "<<f<<" "<<t;
-			return true;
-		}
-		return false;
-	}
+	// rank the include closure in the order the includes expand, breadth first
+	void rankIncludes();
+
+	// rank of an included package, lower rank wins when several packages define one type
+	size_t includeRank(size_t id);
+
+	// keep the best ranked included package which defines ns::name
+	void matchType(const std::string & ns, const std::string & name, size_t & best, SymbolTable*& pBest);
 
 	// search file from "included file" for a specific type
-	void searchFile(const declaredType& type) {
-		// we shall start from scaning the included files instead of scaning the types declared
-		for (std::string & f : _fileIncluded) {
-			//std::cout<<"\n search "<<f;
-			// speed up here! no need to check this file when it is already used
-			if (f!=_file && _fileUsed.find(f)!=_fileUsed.end()) continue;
-			std::string name = type.first, scope = type.second;
-			//std::cout<<"\n matching type "<< name<<" "<<scope;
-			strSet types = _t[f]->types();
-			if (isTypeFound(f,types,scope,name)) return;
-			while (!scope.empty()) {
-				// reduce scope by one namespace
-				size_t pos = scope.find_last_of("::");
-				if (pos != std::string::npos) scope.erase(pos); else scope="";
-				if (isTypeFound(f,types,scope,name)) return;
-			}
-			// well, no scope left, now try "using namespace"
-			for (auto ns=_namespaceUsing.begin();ns!=_namespaceUsing.end();ns++) {
-				if (isTypeFound(f,types,*ns,name)) return;
-			}
-		}
-	}
+	void searchFile(const declaredType& type);
 };
 
 #endif
\ No newline at end of file
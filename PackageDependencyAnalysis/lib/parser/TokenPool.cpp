@@ -0,0 +1,195 @@
+//////////////////////////////////////////////////////////////////////////
+//	TokenPool.cpp - Interns tokens into small integer ids				//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Package Operations:
+===================
+Implements TokenPool and KeywordSet, and tests them
+
+Public Interface:
+=================
+none
+
+Maintanence Information:
+========================
+Required files:
+---------------
+TokenPool.h
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.3 : added clear().
+- ver 0.2 : added KeywordSet.
+- ver 0.1 : initial version.
+
+*/
+#include <cstring>
+#include "TokenPool.h"
+
+// texts of the reserved ids, in the order of Tok::Reserved
+static const char* reservedText[] = {
+	"",
+	// punctuators
+	"\n", "{", "}", ";", "(", ")",
+	"[", "]", ".", "#", ",", ":", "::", "~",
+	"<", ">", "<<", ">>", "<>", ">::", "->",
+	"=", "*", "&", "*&", "&*", "!", "+", "-", "/", "%",
+	"^", "|", "?", "==", "!=", "<=", ">=", "&&", "||",
+	"++", "--", "+=", "-=", "*=", "/=",
+	// keywords
+	"alignas", "alignof", "asm", "auto", "bool", "break", "case", "catch", "char", "char16_t",
+	"char32_t", "class", "const", "constexpr", "const_cast", "continue", "decltype", "default",
+	"delete", "do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+	"false", "final", "float", "for", "friend", "goto", "if", "inline", "int", "long", "mutable",
+	"namespace", "new", "noexcept", "nullptr", "operator", "override", "private",
+	"protected", "public", "register", "reinterpret_cast", "return", "short", "signed",
+	"sizeof", "static", "static_assert", "static_cast", "struct", "switch", "template", "this",
+	"thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+	"unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while",
+	// preprocessor directives
+	"include", "define"
+};
+
+static_assert(sizeof(reservedText) / sizeof(reservedText[0]) == Tok::ReservedCount,
+	"reservedText does not match Tok::Reserved");
+
+// hash table size of a new pool
+static const size_t initialSlots = 512;
+
+// the reserved ids alone, for TokenPool::reserved()
+static const TokenPool reservedPool;
+
+//----< FNV-1a hash of token >---------------------------------------------
+
+static size_t hashOf(const char* text, size_t length) {
+	unsigned int h = 2166136261u;
+	for (size_t i=0;i<length;i++)
+		h = (h ^ (unsigned char)text[i]) * 16777619u;
+	return h;
+}
+
+//----< constructor, enter the reserved tokens with their fixed ids >------
+
+TokenPool::TokenPool() : _slots(initialSlots, Tok::Unknown) {
+	_text.reserve(2 * Tok::ReservedCount);
+	_text.push_back("");	// Tok::Unknown has no slot
+	for (size_t i=1;i<Tok::ReservedCount;i++)
+		intern(reservedText[i], strlen(reservedText[i]));
+}
+
+//----< slot holding token, or the free slot where it belongs >------------
+
+size_t TokenPool::slotOf(const char* text, size_t length) const {
+	size_t mask = _slots.size() - 1, i = hashOf(text, length) & mask;
+	for (;;i=(i+1)&mask) {
+		TokId id = _slots[i];
+		if (id == Tok::Unknown)
+			return i;
+		const std::string& tok = _text[id];
+		if (tok.length() == length && memcmp(tok.data(), text, length) == 0)
+			return i;
+	}
+}
+
+//----< id of token, interning it if it is new >---------------------------
+
+TokId TokenPool::intern(const char* text, size_t length) {
+	size_t i = slotOf(text, length);
+	if (_slots[i] != Tok::Unknown)
+		return _slots[i];
+	TokId id = (TokId)_text.size();
+	_text.push_back(std::string(text, length));
+	_slots[i] = id;
+	if (2 * _text.size() > _slots.size())	// keep the table at most half full
+		grow();
+	return id;
+}
+
+//----< id of token, Tok::Unknown if it was never interned >---------------
+
+TokId TokenPool::find(const char* text, size_t length) const {
+	return _slots[slotOf(text, length)];
+}
+
+//----< double the hash table >--------------------------------------------
+
+void TokenPool::grow() {
+	rehash(2 * _slots.size());
+}
+
+//----< enter the ids in a new hash table >--------------------------------
+
+void TokenPool::rehash(size_t slots) {
+	_slots.assign(slots, Tok::Unknown);
+	for (TokId id=1;id<_text.size();id++)
+		_slots[slotOf(_text[id].data(), _text[id].length())] = id;
+}
+
+//----< forget all tokens but the reserved ones >--------------------------
+
+void TokenPool::clear() {
+	if (_text.size() == Tok::ReservedCount)
+		return;
+	_text.resize(Tok::ReservedCount);
+	rehash(initialSlots);
+}
+
+//----< reserved id of a punctuator or keyword >---------------------------
+
+TokId TokenPool::reserved(const std::string& tok) {
+	return reservedPool.find(tok);
+}
+
+//----< set of the reserved ids of keys, separated by | >----------------
+
+KeywordSet::KeywordSet(const std::string& keys) {
+	memset(_bits, 0, sizeof(_bits));
+	for (size_t start=0, end=0;end!=std::string::npos;start=end+1) {
+		end = keys.find('|', start);
+		TokId id = TokenPool::reserved(keys.substr(start, end-start));
+		if (id != Tok::Unknown)
+			_bits[id / 32] |= 1u << (id % 32);
+	}
+}
+
+#ifdef TEST_TOKENPOOL
+
+#include <iostream>
+
+int main()
+{
+	std::cout << "\n  Testing TokenPool\n ";
+	TokenPool pool;
+	std::cout << "\n reserved ids: " << pool.size();
+	std::cout << "\n typedef is Tok::Typedef: " << (pool.find("typedef") == Tok::Typedef);
+	std::cout << "\n :: is Tok::Scope: " << (TokenPool::reserved("::") == Tok::Scope);
+	TokId id = pool.intern("Graph");
+	std::cout << "\n Graph gets id " << id << ", again " << pool.intern("Graph");
+	std::cout << "\n text of id " << id << ": " << pool.str(id);
+	std::cout << "\n Vertex is not interned: " << (pool.find("Vertex") == Tok::Unknown);
+	std::cout << "\n Graph is not reserved: " << (TokenPool::reserved("Graph") == Tok::Unknown);
+	for (int i=0;i<1000;i++)
+		pool.intern("tok" + std::to_string((long long)i));
+	std::cout << "\n after 1000 more tokens, Graph is still " << pool.find("Graph");
+	pool.clear();
+	std::cout << "\n cleared: " << pool.size() << " ids, Graph is not interned: " << (pool.find("Graph") == Tok::Unknown)
+		<< ", typedef is still Tok::Typedef: " << (pool.find("typedef") == Tok::Typedef);
+	KeywordSet keys("class|struct|union|enum");
+	std::cout << "\n struct is a key: " << keys.contains(Tok::Struct);
+	std::cout << "\n namespace is not a key: " << !keys.contains(Tok::Namespace);
+	std::cout << "\n Graph is not a key: " << !keys.contains(id);
+	std::cout << "\n\n";
+}
+#endif
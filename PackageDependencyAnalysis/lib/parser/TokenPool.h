@@ -0,0 +1,159 @@
+#ifndef TOKENPOOL_H
+#define TOKENPOOL_H
+
+//////////////////////////////////////////////////////////////////////////
+//	TokenPool.h - Interns tokens into small integer ids					//
+//																		//
+//	ver 0.1																//
+//	Language:		Visual C++ 2012, SP1								//
+//	Platform:		Dell Studio 1558, Windows 7 Pro x64 Sp1				//
+//	Application:	Type Dependency Analysis							//
+//	Author:			Kevin Wang, Syracuse University						//
+//					kevixw@gmail.com									//
+//////////////////////////////////////////////////////////////////////////
+/*
+Module Operations:
+==================
+A TokenPool gives every distinct token text a 32-bit id, so that tokens
+can be compared by id instead of by string.  Punctuators and C++ keywords
+have reserved ids, the same in every pool, named in the Tok namespace:
+rules compare a token with Tok::LeftBrace or Tok::Typedef directly.  Other
+tokens get the next free id the first time they are interned.
+
+The pool is an open addressing hash table over the token texts, so a token
+is looked up from a pointer and a length, a slice of the source, without
+constructing a std::string.  Only a new token is copied into the pool.
+
+A KeywordSet is a fixed set of reserved ids, such as the keywords a rule
+looks for.  It is a bit table indexed by the id itself, so a membership
+test is one shift and one mask, and no string is built for a lookup.
+
+A pool is not thread safe; each SemiExp owns one, so parsing threads never
+share a pool.  Ids of non-reserved tokens are meaningful only within the
+pool that issued them, and only until the pool is cleared: clear() forgets
+every token but the reserved ones, so a pool used for file after file does
+not keep the names of all of them.
+
+Public Interface:
+=================
+TokenPool pool;
+TokId id = pool.intern(text, length);
+TokId id = pool.intern("Graph");
+TokId id = pool.find("Graph");	// Tok::Unknown if never interned
+const std::string& tok = pool.str(id);
+size_t n = pool.size();
+pool.clear();	// only the reserved ids are left
+TokId id = TokenPool::reserved("typedef");	// Tok::Typedef
+KeywordSet keys("class|struct|union|enum");
+bool res = keys.contains(id);
+
+Maintanence Information:
+========================
+Required files:
+---------------
+TokenPool.h, TokenPool.cpp
+
+Build Process:
+--------------
+Using Visual Studio Command Prompt:
+devenv PackageDependencyAnalysis.sln /rebuild debug
+
+Revision History:
+-----------------
+- ver 0.3 added clear()
+- ver 0.2 added KeywordSet
+- ver 0.1 first version
+
+*/
+
+#include <string>
+#include <vector>
+
+typedef unsigned int TokId;
+
+///////////////////////////////////////////////////////////////
+// reserved token ids, in the order of the table in TokenPool.cpp
+namespace Tok {
+
+	enum Reserved {
+		Unknown = 0,	// not a token of the pool
+		// punctuators
+		NewLine, LeftBrace, RightBrace, Semicolon, LeftParen, RightParen,
+		LeftBracket, RightBracket, Dot, Pound, Comma, Colon, Scope, Tilde,
+		Less, Greater, ShiftLeft, ShiftRight, EmptyAngles, CloseScope, Arrow,
+		Assign, Star, Amp, StarAmp, AmpStar, Not, Plus, Minus, Slash, Percent,
+		Caret, Bar, Question, Equal, NotEqual, LessEqual, GreaterEqual, And, Or,
+		Increment, Decrement, PlusAssign, MinusAssign, StarAssign, SlashAssign,
+		// keywords
+		Alignas, Alignof, Asm, Auto, Bool, Break, Case, Catch, Char, Char16T,
+		Char32T, Class, Const, Constexpr, ConstCast, Continue, Decltype, Default,
+		Delete, Do, Double, DynamicCast, Else, Enum, Explicit, Export, Extern,
+		False, Final, Float, For, Friend, Goto, If, Inline, Int, Long, Mutable,
+		Namespace, New, Noexcept, Nullptr, Operator, Override, Private,
+		Protected, Public, Register, ReinterpretCast, Return, Short, Signed,
+		Sizeof, Static, StaticAssert, StaticCast, Struct, Switch, Template, This,
+		ThreadLocal, Throw, True, Try, Typedef, Typeid, Typename, Union,
+		Unsigned, Using, Virtual, Void, Volatile, WcharT, While,
+		// preprocessor directives
+		Include, Define,
+		ReservedCount	// first id given to other tokens
+	};
+}
+
+///////////////////////////////////////////////////////////////
+// TokenPool class
+class TokenPool {
+public:
+	TokenPool();
+
+	// id of token, interning it if it is new
+	TokId intern(const char* text, size_t length);
+	TokId intern(const std::string& tok) { return intern(tok.data(), tok.length()); }
+
+	// id of token, Tok::Unknown if it was never interned
+	TokId find(const char* text, size_t length) const;
+	TokId find(const std::string& tok) const { return find(tok.data(), tok.length()); }
+
+	// text of token id, valid until the next intern()
+	const std::string& str(TokId id) const { return _text[id]; }
+
+	// number of ids in use, Tok::Unknown included
+	size_t size() const { return _text.size(); }
+
+	// forget all tokens but the reserved ones
+	void clear();
+
+	// reserved id of a punctuator or keyword, Tok::Unknown for other tokens
+	static TokId reserved(const std::string& tok);
+
+private:
+	std::vector<std::string> _text;	// id -> token text
+	std::vector<TokId> _slots;	// hash table of ids, Tok::Unknown marks a free slot
+
+	// slot holding token, or the free slot where it belongs
+	size_t slotOf(const char* text, size_t length) const;
+
+	// double the hash table
+	void grow();
+
+	// enter the ids in a new hash table of slots entries, a power of 2
+	void rehash(size_t slots);
+};
+
+///////////////////////////////////////////////////////////////
+// KeywordSet class, a set of reserved ids
+class KeywordSet {
+public:
+	// keys is a list of keywords separated by |, e.g. "class|struct"
+	explicit KeywordSet(const std::string& keys);
+
+	// whether id is one of the keywords, Tok::Unknown and other tokens never are
+	bool contains(TokId id) const {
+		return id < Tok::ReservedCount && (_bits[id / 32] >> (id % 32) & 1) != 0;
+	}
+
+private:
+	unsigned int _bits[(Tok::ReservedCount + 31) / 32];
+};
+
+#endif
@@ -18,7 +18,8 @@ variables more conveniently
 
 Public Interface:
 =================
-TokenProcessor::getKnownParentElem(p_Repo);
+const element& parent = TokenProcessor::getKnownParentElem(p_Repo);
+std::string name = TokenProcessor::getKnownParentPrefix(p_Repo) + "x";
 TokenProcessor::readTokCollection(pTc,pos,p_Repo,nameScope);
 std::string name = TokenProcessor::getTypenameTemplate(pTc,pos);
 TokenProcessor::appendTemplate(name,pos);
@@ -27,10 +28,19 @@ std::string name = TokenProcessor::getTypename(pTc,pos);
 Build Process:
 ==============
 Required files
-- ActionsAndRules.h, itokcollection.h, StringHelper.h
+- ActionsAndRules.h, itokcollection.h, StringHelper.h, SymbolDatabase.h
 
 Maintenance History:
 ====================
+ver 0.5 : 17 Oct 26
+- modifier keywords are skipped by token id
+ver 0.4 : 17 Oct 26
+- known parent and its "::" prefix come from the scope stack's per depth
+  cache, without popping and pushing the stack
+ver 0.3 : 17 Oct 26
+- punctuators and keywords are tested by interned token id
+ver 0.2 : 17 Oct 26
+- Repository carries the SymbolDatabase the symbol tables come from
 ver 0.1 : 19 Mar 13
 - first version
 
@@ -41,6 +51,7 @@ ver 0.1 : 19 Mar 13
 #include "StringHelper.h"
 #include "itokcollection.h"
 #include "SymbolTable.h"
+#include "SymbolDatabase.h"
 #include "Tokenizer.h"
 
 ///////////////////////////////////////////////////////////////
@@ -51,6 +62,12 @@ struct element
 	std::string type;
 	std::string name;
 	size_t lineCount;
+	// whether names declared in this scope are qualified by its name
+	bool isKnown() const
+	{
+		return type=="type" || type=="namespace" || type=="function"
+			|| type=="exception" || type=="loop" || type=="case";
+	}
 	std::string show()
 	{
 		std::ostringstream temp;
@@ -76,18 +93,25 @@ class Repository  // application specific
 	/////////////////////////////////////
 	// Add one symbol table here - Kevin Wang
 	SymbolTable* p_Symbol;
+	SymbolDatabase* p_Database;	// owns the symbol tables of all files
 	// End of Add
 	////////////////////////////////////
+	element none;	// known parent of an empty scope stack
+	////////////////////////////////////
 public:
 	/////////////////////////////////////
 	// Change constructor here - Kevin Wang
-	Repository(Toker* pToker) : p_Toker(pToker) {}
+	Repository(Toker* pToker, SymbolDatabase* pDatabase) : p_Toker(pToker), p_Symbol(0), p_Database(pDatabase) {}
 	// End of Change
 	////////////////////////////////////
 	ScopeStack<element>& scopeStack()
 	{
 		return stack;
 	}
+	const element& noScope()
+	{
+		return none;
+	}
 	Toker* Toker()
 	{
 		return p_Toker;
@@ -101,6 +125,9 @@ public:
 	SymbolTable*& Symbols() {
 		return p_Symbol;
 	}
+	SymbolDatabase* Database() {
+		return p_Database;
+	}
 	// End of Add
 	////////////////////////////////////
 };
@@ -112,7 +139,6 @@ class TokenProcessor {
 
 	// delete all white space in token collection
 	static inline void filterWhitespace(ITokCollection*& pTc, size_t& pos) {
-		std::locale loc;
 		while (pos<pTc->length() && Helper::isSpace((*pTc)[pos])) pos++;
 	}
 
@@ -121,7 +147,8 @@ class TokenProcessor {
 		if (pos>=pTc->length() || pos<1)
 			return false;
 		while (pos>1 && Helper::isSpace((*pTc)[pos])) pos--;
-		return (*pTc)[pos]=="(" || (*pTc)[pos]==")" || (*pTc)[pos]==";" 
+		TokId id = pTc->id(pos);
+		return id==Tok::LeftParen || id==Tok::RightParen || id==Tok::Semicolon
 			|| (*pTc)[pos].find('[')!=std::string::npos || (*pTc)[pos].find(']')!=std::string::npos;
 	}
 
@@ -160,11 +187,12 @@ class TokenProcessor {
 		std::string name;
 		ITokCollection& tc = *pTc;
 		for (size_t startPos=pos; pos<tc.length();pos++) {
-			if (Helper::isSpace(tc[pos]) || Helper::isModifierKeyword(tc[pos])) { startPos++; continue; }	// delete all whitespace again
+			if (Helper::isSpace(tc[pos]) || Helper::isModifierKeyword(tc.id(pos))) { startPos++; continue; }	// delete all whitespace again
 			bracket+=countBracket(tc[pos]);
-			if (tc[pos]==";" || tc[pos]=="(" || tc[pos]==")" || tc[pos].find("[")!=std::string::npos || tc[pos].find("]")!=std::string::npos || bracket<0)
+			TokId id = tc.id(pos);
+			if (id==Tok::Semicolon || id==Tok::LeftParen || id==Tok::RightParen || tc[pos].find("[")!=std::string::npos || tc[pos].find("]")!=std::string::npos || bracket<0)
 				bracket=0;	// reset bracket count , as the < may really mean less than
-			else if (tc[pos]==">>" && bracket<0) bracket+=2;
+			else if (id==Tok::ShiftRight && bracket<0) bracket+=2;
 			else if (tc[pos].find("::")!=std::string::npos || tc[pos].find('.')!=std::string::npos || tc[pos].find("->")!=std::string::npos)
 				startPos=pos+1;	// namespace or nested class
 			else if (!bracket && tc[pos].find('>')!=std::string::npos) {
@@ -173,7 +201,7 @@ class TokenProcessor {
 			if ((int)(pos-startPos)>0 && bracket==0) break;
 			name += tc[pos];	// pos should be at the next available position
 		}
-		while (pos<tc.length() && tc[pos]==")") pos++;	// does not filter ( here
+		while (pos<tc.length() && tc.id(pos)==Tok::RightParen) pos++;	// does not filter ( here
 		filterMethod(name);
 		return name;
 	}
@@ -201,19 +229,19 @@ public:
 
 	///////////////////////////////////////////////////////////////
 	// this func is used to get the parent element, extremely useful when trying figuring out in which scope we are now
+	// the reference is valid until the scope stack is changed
 
-	static element getKnownParentElem(Repository* pRepos, const std::string& type="type|namespace|function|exception|loop|case") {
-		element elem, res;
+	static const element& getKnownParentElem(Repository* pRepos) {
 		if (pRepos->scopeStack().size()<1)	// return an empty element
-			return res;
-		elem = pRepos->scopeStack().pop();
-		res = 
-			(("|"+type+"|").find("|"+elem.type+"|") == std::string::npos && pRepos->scopeStack().size()>0)
-			? getKnownParentElem(pRepos,type)	// call recursively
-			: elem;
-		// push back
-		pRepos->scopeStack().push(elem);
-		return res;
+			return pRepos->noScope();
+		return pRepos->scopeStack().knownParent();
+	}
+
+	///////////////////////////////////////////////////////////////
+	// name of the parent element followed by "::", to qualify a name declared in it
+
+	static const std::string& getKnownParentPrefix(Repository* pRepos) {
+		return pRepos->scopeStack().knownPrefix();
 	}
 
 	///////////////////////////////////////////////////////////////
@@ -221,13 +249,13 @@ public:
 
 	static std::string getTypenameTemplate(ITokCollection*& pTc, size_t& pos) {
 		ITokCollection& tc = *pTc;
-		size_t p=tc.find("template")+1;
+		size_t p=tc.find(Tok::Template)+1;
 		filterWhitespace(pTc, p);
 		if (p>tc.length()-1) return "";
 		std::string templ;
 		size_t bracket=0;
 		for (bracket = countBracket(tc[p]);bracket>0 && p<tc.length()-1;bracket+=countBracket(tc[++p])) {
-			if (tc[p]!="class" && tc[p]!="typename" && !Helper::isSpace(tc[p]))
+			if (tc.id(p)!=Tok::Class && tc.id(p)!=Tok::Typename && !Helper::isSpace(tc[p]))
 				templ += tc[p];
 		}
 		// normally bracket will be zero at this stage
@@ -255,10 +283,10 @@ public:
 		if (pos>=pTc->length()) return "";
 		ITokCollection& tc = *pTc;
 		std::string name, templ = readTemplate ? getTypenameTemplate(pTc,pos) : "";
-		while (pos<pTc->length() && (Helper::isSpace(tc[pos]) || tc[pos]=="(" || tc[pos]==")")) pos++;	// ignore modifier and whitespace
+		while (pos<pTc->length() && (Helper::isSpace(tc[pos]) || tc.id(pos)==Tok::LeftParen || tc.id(pos)==Tok::RightParen)) pos++;	// ignore modifier and whitespace
 		size_t initPos=pos;
 		int bracket=0;
-		if (pos<pTc->length() && tc[pos]=="~") {
+		if (pos<pTc->length() && tc.id(pos)==Tok::Tilde) {
 			name+="~";
 			pos++;
 		}
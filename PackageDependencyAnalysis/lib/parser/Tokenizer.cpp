@@ -1,6 +1,6 @@
 /////////////////////////////////////////////////////////////////////
 //  Tokenizer.cpp - Reads words from a file                        //
-//  ver 2.2                                                        //
+//  ver 2.6                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -9,20 +9,83 @@
 //                 (315) 443-3948, jfawcett@twcny.rr.com           //
 /////////////////////////////////////////////////////////////////////
 
-#include <cctype>
-#include <locale>
-#include <fstream>
-#include <sstream>
 #include <iomanip>
 #include <assert.h>
 #include "Tokenizer.h"
+#include "CharClass.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TOKER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+//----< fast scans of source text >----------------------------
+//  with SSE2, 16 chars are compared at once, the scalar loops
+//  finish the tail and are all there is on other targets
+
+#ifdef TOKER_SSE2
+static inline unsigned lowestBit(unsigned mask)
+{
+#ifdef _MSC_VER
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return index;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+//----< return first ch in [p,end), end if none >--------------
+
+static const char* findChar(const char* p, const char* end, char ch)
+{
+#ifdef TOKER_SSE2
+  __m128i key = _mm_set1_epi8(ch);
+  for(; end - p >= 16; p += 16)
+  {
+    __m128i block = _mm_loadu_si128((const __m128i*)p);
+    unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, key));
+    if(mask != 0)
+      return p + lowestBit(mask);
+  }
+#endif
+  for(; p < end; ++p)
+    if(*p == ch)
+      return p;
+  return end;
+}
+//----< return number of newlines in [p,end) >-----------------
+
+static int countLines(const char* p, const char* end)
+{
+  int count = 0;
+#ifdef TOKER_SSE2
+  __m128i key = _mm_set1_epi8('\n');
+  for(; end - p >= 16; p += 16)
+  {
+    __m128i block = _mm_loadu_si128((const __m128i*)p);
+    unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(block, key));
+    for(; mask != 0; mask &= mask - 1)
+      ++count;
+  }
+#endif
+  for(; p < end; ++p)
+    if(*p == '\n')
+      ++count;
+  return count;
+}
 
 //----< constructor may be called with no argument >-----------
 
 Toker::Toker(const std::string& src, bool isFile) 
-     : prevprevChar(0), prevChar(0), currChar(0), nextChar(0),
+     : pCur(0), pLast(0), pEnd(0), pastEnd(false),
+       prevprevChar(0), prevChar(0), currChar(0), nextChar(0),
+       numLines(0), braceCount(0),
        doReturnComments(false), doReturnSingleQuotesAsToken(true),
-       numLines(0), braceCount(0), pIn(0),
        _state(default_state), EndQuoteCounter(false)
 {
   if(src.length() > 0)
@@ -36,21 +99,12 @@ Toker::Toker(const std::string& src, bool isFile)
   scTok = "()[]{};.\n";
   if(_mode == xml)
     scTok = "<>!" + scTok;
+  buildSingleCharTable();
 }
-//----< destructor >-------------------------------------------
+//----< destructor, the file mapping is released by its member >--
 
 Toker::~Toker()
 {
-  if(pIn)
-  {
-    pIn->clear();
-    std::ifstream* pFs = dynamic_cast<std::ifstream*>(pIn);
-    if(pFs)
-    {
-      pFs->close();
-    }
-    delete pIn;
-  }
 }
 //----< set mode for collecting single quoted strings >--------
 
@@ -58,6 +112,7 @@ void Toker::returnSingleQuotedStringAsToken(bool doReturn)
 { 
   doReturnSingleQuotesAsToken = doReturn; 
   scTok += "\'";
+  buildSingleCharTable();
 }
 
 //----< set mode of tokenizing, e.g., code or xml >------------
@@ -68,6 +123,7 @@ void Toker::setMode(Toker::mode md)
   scTok = "()[]{};.\n";
   if(_mode == xml)
     scTok = "<>!" + scTok;
+  buildSingleCharTable();
 }
 //----< set mode of tokenizing, e.g., code or xml >------------
 
@@ -75,6 +131,16 @@ void Toker::setSingleCharTokens(std::string tokChars)
 { 
   _mode = custom; 
   scTok = tokChars;
+  buildSingleCharTable();
+}
+//----< mark single char tokens in lookup table >--------------
+
+void Toker::buildSingleCharTable()
+{
+  for(size_t i=0; i<256; ++i)
+    scTable[i] = false;
+  for(size_t i=0; i<scTok.length(); ++i)
+    scTable[(unsigned char)scTok[i]] = true;
 }
 //----< attach tokenizer to a source file or string >----------
 
@@ -82,52 +148,73 @@ bool Toker::attach(const std::string& name, bool srcIsFile)
 {
   prevprevChar = prevChar = currChar = nextChar = 0;
   numLines = braceCount = 0;
+  pastEnd = false;
+  pLast = 0;
+  _state = default_state;
+  EndQuoteCounter = false;
 
-  if(pIn && srcIsFile)
+  bool ok = true;
+  if(srcIsFile)
   {
-    pIn->clear();
-    std::ifstream* pFs = dynamic_cast<std::ifstream*>(pIn);
-    if(pFs)
-    {
-      pFs->close();
-    }
+    text.clear();
+    ok = file.open(name);
+    pCur = file.data();
+    pEnd = pCur + file.size();
   }
-  if(srcIsFile)
-    pIn = new std::ifstream(name.c_str());
   else
-    pIn = new std::istringstream(name.c_str());
-  return pIn->good();
+  {
+    file.close();
+    text = name.c_str();
+    pCur = text.data();
+    pEnd = pCur + text.size();
+  }
+  return ok;
 }
-//----< peek function that works with multiple putbacks >------
+//----< peek at next char, -1 at end of source >---------------
+//  on Windows a CR before LF reads as the LF, as text mode
+//  streams did; nothing is consumed
 
 int Toker::peek()
 {
-  if(putbacks.size() > 0)
-    return putbacks[putbacks.size()-1];
-  else
-    return pIn->peek();
-
+  if(pCur >= pEnd)
+    return -1;
+#ifdef _WIN32
+  if(*pCur == '\r' && pCur + 1 < pEnd && pCur[1] == '\n')
+    return '\n';
+#endif
+  return (unsigned char)*pCur;
 }
-//----< multiple putBack that won't break peek >---------------
+//----< put back last char read, ch, so it will be read again >--
 
 void Toker::putback(int ch)
 {
-  putbacks.push_back(ch);
+  pCur = pLast;
+  pastEnd = false;
   nextChar = ch;
   currChar = prevChar;
   prevChar = prevprevChar;
 }
-//----< get consistent with peek and putback >-----------------
+//----< get next char, -1 at end of source >-------------------
+//  a CR before LF is consumed with it on Windows, pLast holds
+//  the address of the char returned
 
 int Toker::get()
 {
-  if(putbacks.size() > 0)
-  {
-    char ch = putbacks.front();
-    putbacks.pop_back();
-    return ch;
-  }
-  return pIn->get();
+  pastEnd = !(pCur < pEnd);
+  if(pastEnd)
+    return -1;
+#ifdef _WIN32
+  if(*pCur == '\r' && pCur + 1 < pEnd && pCur[1] == '\n')
+    ++pCur;
+#endif
+  pLast = pCur++;
+  return (unsigned char)*pLast;
+}
+//----< are there chars left to read? >------------------------
+
+bool Toker::good()
+{
+  return pCur < pEnd;
 }
 //
 //----< extract character from attached stream >---------------
@@ -146,15 +233,110 @@ bool Toker::getChar()
     ++braceCount;
   if(currChar == '}' && _state == default_state)
     --braceCount;
-  return !pIn->eof();
+  return good();
+}
+//----< add current char, just read, to token >----------------
+//  chars read past end of source are not part of the source
+
+void Toker::append(Token& tok)
+{
+  if(pastEnd)
+    return;
+  if(tok.length == 0)
+  {
+    tok.text = pLast;
+    tok.line = numLines + (currChar == '\n' ? 0 : 1);
+  }
+  tok.length = pCur - tok.text;
+}
+//----< jump to p, as if all chars before p were read >--------
+//  used inside comments, quotes and white space, where no
+//  braces are counted; short jumps are left to getChar()
+
+void Toker::skipTo(const char* p)
+{
+  if(p < pCur + 6)
+    return;
+  numLines += countLines(pCur, p);
+  pCur = p;
+  pLast = p - 1;
+  pastEnd = false;
+  char* last[] = { &currChar, &prevChar, &prevprevChar };
+  const char* q = p;
+  for(int i=0; i<3; ++i)
+  {
+    --q;
+#ifdef _WIN32
+    if(*q == '\r' && q + 1 < pEnd && q[1] == '\n')
+      --q;
+#endif
+    *last[i] = *q;
+  }
+  nextChar = peek();
+}
+//----< where the current comment ends >-----------------------
+//  a C comment ends at a "*/" whose star is not escaped, the
+//  opening star included, a C++ comment at the end of a line
+//  that does not end with a backslash
+
+const char* Toker::endOfComment()
+{
+  if(aCppComment)
+  {
+    for(const char* n = findChar(pCur + 1, pEnd, '\n'); n < pEnd; n = findChar(n + 1, pEnd, '\n'))
+    {
+      const char* prev = n - 1;
+#ifdef _WIN32
+      if(*prev == '\r')
+        --prev;
+#endif
+      if(*prev != '\\')
+        return prev + 1;
+    }
+    return pEnd;
+  }
+  for(const char* s = findChar(pCur + 1, pEnd, '/'); s < pEnd; s = findChar(s + 1, pEnd, '/'))
+    if(s[-1] == '*' && s[-2] != '\\')
+      return s - 1;
+  return pEnd;
+}
+//----< where the last chars of the current quote start >------
+//  the closing quote is the first one after an even number of
+//  backslashes, the scan returns the start of those backslashes
+
+const char* Toker::endOfQuote()
+{
+  char quote = aSingleQuote ? '\'' : '\"';
+  for(const char* q = findChar(pCur, pEnd, quote); q < pEnd; q = findChar(q + 1, pEnd, quote))
+  {
+    const char* r = q;
+    while(r[-1] == '\\')  // stops at the opening quote
+      --r;
+    if((q - r) % 2 == 0)
+      return r;
+  }
+  return pEnd;
+}
+//----< where the current run of white space ends >------------
+
+const char* Toker::endOfWhiteSpace()
+{
+  const char* p = pCur;
+  while(p < pEnd && CharClass::isSpace(*p) && *p != '\n')
+  {
+#ifdef _WIN32
+    if(*p == '\r' && p + 1 < pEnd && p[1] == '\n')
+      break;
+#endif
+    ++p;
+  }
+  return p;
 }
 //----< is this char a single char token? >--------------------
 
 bool Toker::isSingleCharTok(char ch)
 {
-  if(scTok.find(ch) < scTok.length())
-    return true;
-  return false;
+  return scTable[(unsigned char)ch];
 }
 //----< remove contiguous white space except for newline >-----
 
@@ -162,8 +344,9 @@ void Toker::stripWhiteSpace()
 {
   if(nextChar == '\n')
     return;
-  std::locale loc;
-  while(isspace(nextChar, loc) && nextChar != '\n')
+  if(CharClass::isSpace(nextChar))
+    skipTo(endOfWhiteSpace());
+  while(CharClass::isSpace(nextChar) && nextChar != '\n')
   {
     getChar();
   }
@@ -172,17 +355,13 @@ void Toker::stripWhiteSpace()
 
 bool Toker::isIdentifierChar(char ch)
 {
-  std::locale loc;
-  if(isalpha(ch, loc) || ch == '_' || isdigit(ch, loc))
-    return true;
-  return false;
+  return CharClass::isIdentifier(ch);
 }
 //----< is this the end of a token? >--------------------------
 
 bool Toker::isTokEnd()
 {
-  std::locale loc;
-  if(isspace(nextChar, loc))
+  if(CharClass::isSpace(nextChar))
     return true;
   if(isSingleCharTok(nextChar) || isSingleCharTok(currChar))
     return true;
@@ -198,12 +377,14 @@ bool Toker::isTokEnd()
 
 bool Toker::isBeginComment()
 {
-  if(prevChar != '\\' && currChar == '/' && nextChar == '*')
+  if(!CharClass::is(currChar, CharClass::Slash) || prevChar == '\\')
+    return false;
+  if(nextChar == '*')
   {
     aCppComment = false;
     return true;
   }
-  if(prevChar != '\\' && currChar == '/' && nextChar == '/')
+  if(nextChar == '/')
   {
     aCppComment = true;
     return true;
@@ -222,20 +403,23 @@ bool Toker::isEndComment()
 }
 //----< return comment as a token >----------------------------
 
-std::string Toker::eatComment()
+Token Toker::eatComment()
 {
   _state = comment_state;
-  std::string tok(1,currChar);
-  while(!isEndComment() && pIn->good())
+  Token tok = { pCur, 0, 0 };
+  append(tok);
+  skipTo(endOfComment());
+  append(tok);
+  while(!isEndComment() && good())
   {
     getChar();
-    tok.append(1,currChar);
+    append(tok);
   }
 
   if(!aCppComment)
   {
     getChar();
-    tok.append(1,currChar);
+    append(tok);
   }
   _state = default_state;
   return tok;
@@ -244,12 +428,14 @@ std::string Toker::eatComment()
 
 bool Toker::isBeginQuote()
 {
-  if(prevChar != '\\' && currChar == '\'' && doReturnSingleQuotesAsToken)
+  if(!CharClass::isQuote(currChar) || prevChar == '\\')
+    return false;
+  if(currChar == '\'' && doReturnSingleQuotesAsToken)
   {
     aSingleQuote = true;
     return true;
   }
-  if(prevChar != '\\' && currChar == '\"')
+  if(currChar == '\"')
   {
     aSingleQuote = false;
     return true;
@@ -287,17 +473,20 @@ bool Toker::isEndQuote()
 }
 //----< return single or double quote as token >---------------
 
-std::string Toker::eatQuote()
+Token Toker::eatQuote()
 {
   _state = quote_state;
-  std::string tok(1,currChar);
-  while(!isEndQuote())
+  Token tok = { pCur, 0, 0 };
+  append(tok);
+  skipTo(endOfQuote());
+  append(tok);
+  while(!isEndQuote() && good())
   {
     getChar();
-    tok.append(1,currChar);
+    append(tok);
   }
   getChar();
-  tok.append(1,currChar);
+  append(tok);
   _state = default_state;
   return tok;
 }
@@ -305,12 +494,18 @@ std::string Toker::eatQuote()
 
 std::string Toker::getTok()
 {
-  std::string tok = "";
+  return getTokView().str();
+}
+//----< read token as a slice of the source, no copy >---------
+
+Token Toker::getTokView()
+{
+  Token tok = { pCur, 0, numLines + 1 };
   stripWhiteSpace();
   if(isSingleCharTok(nextChar))
   {
     getChar();
-    tok.append(1,currChar);
+    append(tok);
     return tok;
   }
   do
@@ -321,7 +516,7 @@ std::string Toker::getTok()
     getChar();
     if(isBeginComment())
     {
-      if(tok.length() > 0)
+      if(tok.length > 0)
       {
         this->putback(currChar);
         return tok;
@@ -331,13 +526,13 @@ std::string Toker::getTok()
         return tok;
       else
       {
-        tok = "";
+        tok.length = 0;
         continue;
       }
     }
     if(isBeginQuote())
     {
-      if(tok.length() > 0)
+      if(tok.length > 0)
       {
         this->putback(currChar);
         return tok;
@@ -345,10 +540,9 @@ std::string Toker::getTok()
       tok = eatQuote();
       return tok;
     }
-    std::locale loc;
-    if(!isspace(currChar, loc))
-      tok.append(1,currChar);
-  }  while(!isTokEnd() || tok.length() == 0);
+    if(!CharClass::isSpace(currChar))
+      append(tok);
+  }  while(!isTokEnd() || tok.length == 0);
   return tok;
 }
 //----< test stub >--------------------------------------------
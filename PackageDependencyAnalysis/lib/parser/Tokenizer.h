@@ -2,7 +2,7 @@
 #define TOKENIZER_H
 /////////////////////////////////////////////////////////////////////
 //  Tokenizer.h - Reads words from a file                          //
-//  ver 2.2                                                        //
+//  ver 2.6                                                        //
 //                                                                 //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
@@ -30,25 +30,53 @@
   A tokenizer is an important part of a scanner, used to read and interpret
   source code or XML.
 
+  Files are memory mapped (see MappedFile) and strings are copied once, so
+  the tokenizer scans one contiguous block of characters.  getTokView()
+  returns each token as a Token, a slice of that block with the line it
+  starts on, without allocating.  Tokens stay valid until the Toker is
+  attached to another source or destroyed.  getTok() returns a copy.
+
   Public Interface:
   =================
   Toker t;                        // create tokenizer instance
   returnComments();               // request comments return as tokens
   if(t.attach(someFileName))      // select file for tokenizing
     string tok = t.getTok();      // extract first token
+  Token tv = t.getTokView();      // extract token without copying it
+  if(tv == "{")                   // compare with a string
+    string tok = tv.str();        // copy of tv.text, tv.length chars
+  int line = tv.line;             // line on which token starts
   int numLines = t.lines();       // return number of lines encountered
   t.lines() = 0;                  // reset line count
 
   Build Process:
   ==============
   Required files
-    - tokenizer.h, tokenizer.cpp
+    - tokenizer.h, tokenizer.cpp, MappedFile.h, MappedFile.cpp, CharClass.h
   Build commands (either one)
     - devenv Project1HelpS06.sln
-    - cl /EHsc /DTEST_TOKENIZER tokenizer.cpp /link setargv.obj
+    - cl /EHsc /DTEST_TOKENIZER tokenizer.cpp MappedFile.cpp /link setargv.obj
 
   Maintenance History:
   ====================
+  ver 2.6 : 17 Oct 26
+  - on Windows, peek() no longer moves past the CR of a CRLF, get()
+    consumes both and tokens start at the char get() returned; the
+    last char of each CRLF line was lost before
+  - attach() also resets the comment and quote state, so one Toker
+    can be reused for many files
+  ver 2.5 : 17 Oct 26
+  - comments, quotes and runs of white space are scanned to their end
+    in one pass, 16 chars at a time with SSE2, and skipped at once;
+    line count is updated by counting the newlines skipped
+  ver 2.4 : 17 Oct 26
+  - character tests look up CharClass and a table of single char
+    tokens, instead of constructing a locale or searching scTok
+  ver 2.3 : 17 Oct 26
+  - source is a memory mapped file or a copy of the string, read
+    through a pointer instead of an istream
+  - added getTokView(), returning tokens as slices of the source
+  - unterminated quote at end of source no longer loops forever
   ver 2.2 : 23 Feb 13
   - fixed bug reported with suggested fix by Kevin Wang.  Use of 
     cctype functions without locale caused crashes in several low-level
@@ -98,8 +126,25 @@
 */
 //
 #include <string>
+#include <cstring>
 #include <iostream>
-#include <vector>
+#include "MappedFile.h"
+
+///////////////////////////////////////////////////////////////
+// Token - slice of the tokenizer's source, not null terminated
+
+struct Token
+{
+  const char* text;
+  size_t length;
+  int line;           // line on which token starts, first line is 1
+  std::string str() const { return std::string(text, length); }
+  bool operator==(const char* s) const
+  {
+    return strlen(s) == length && memcmp(text, s, length) == 0;
+  }
+  bool operator!=(const char* s) const { return !(*this == s); }
+};
 
 class Toker
 {
@@ -111,6 +156,7 @@ public:
   void setSingleCharTokens(std::string tokChars);
   bool attach(const std::string& filename, bool isFile = true);
   std::string getTok();
+  Token getTokView();
   void returnComments(bool doReturn = true);
   void returnSingleQuotedStringAsToken(bool doCollect=true);
   int& lines();
@@ -121,10 +167,15 @@ public:
   enum state { default_state, comment_state, quote_state };
 
 private:
-  std::istream* pIn;
+  MappedFile file;          // source when attached to a file
+  std::string text;         // source when attached to a string
+  const char* pCur;         // next character to read
+  const char* pLast;        // last character read
+  const char* pEnd;         // one past last character
+  bool pastEnd;             // last char was read past end of source
   char prevprevChar, prevChar, currChar, nextChar;
   std::string scTok;
-  std::vector<char> putbacks;
+  bool scTable[256];        // scTable[ch] is true when ch is in scTok
   int numLines;
   int braceCount;
   bool doReturnComments;
@@ -136,18 +187,25 @@ private:
 
   // private helper functions
   int  get();
+  bool good();
   bool getChar();
+  void append(Token& tok);
+  void skipTo(const char* p);
+  const char* endOfComment();
+  const char* endOfQuote();
+  const char* endOfWhiteSpace();
+  void buildSingleCharTable();
   bool isSingleCharTok(char ch);
   bool isTokEnd();
   void stripWhiteSpace();
   bool isIdentifierChar(char ch);
   bool isBeginComment();
   bool isEndComment();
-  std::string eatComment();
+  Token eatComment();
   bool aSingleQuote;
   bool isBeginQuote();
   bool isEndQuote();
-  std::string eatQuote();
+  Token eatQuote();
 
   // prohibit copying and assignment
   Toker(const Toker &tkr);
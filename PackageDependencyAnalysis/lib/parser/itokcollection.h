@@ -2,7 +2,7 @@
 #define ITOKCOLLECTION_H
 /////////////////////////////////////////////////////////////////////
 //  ITokCollection.h - package for the ITokCollection interface    //
-//  ver 1.1                                                        //
+//  ver 1.2                                                        //
 //  Language:      Visual C++ 2008, SP1                            //
 //  Platform:      Dell Precision T7400, Vista Ultimate SP1        //
 //  Application:   Prototype for CSE687 Pr1, Sp09                  //
@@ -20,18 +20,25 @@
 
   Maintenance History:
   ====================
+  ver 1.2 : 17 Oct 26
+  - added id(n) and find(id), tokens are compared by interned id
   ver 1.1 : 02 Jun 11
   - added merge, remove overload, and default param in get
   ver 1.0 : 17 Jan 09
   - first release
 */
 
+#include <string>
+#include "TokenPool.h"
+
 struct ITokCollection
 {
   virtual bool get(bool clear=true)=0;
   virtual size_t length()=0;
   virtual std::string& operator[](int n)=0;
   virtual size_t find(const std::string& tok)=0;
+  virtual TokId id(size_t n)=0;
+  virtual size_t find(TokId id)=0;
   virtual void push_back(const std::string& tok)=0;
   virtual bool merge(const std::string& firstTok, const std::string& secondTok)=0;
   virtual bool remove(const std::string& tok)=0;